@@ -29,6 +29,15 @@
 #include <time.h>
 #include <unistd.h>
 #include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifdef __linux__
+# include <sys/syscall.h>
+# include <linux/memfd.h>
+# include <linux/futex.h>
+# include <sys/eventfd.h>
+# include <sys/epoll.h>
+#endif
 
 #define TRUE  1
 #define FALSE 0
@@ -46,6 +55,43 @@
 #ifndef CLOCK_MONOTONIC
 # define CLOCK_MONOTONIC 1
 #endif
+#ifdef __linux__
+/* Waiting on several futexes (Linux 5.16 or more recent), the system call
+   number is the same for all architectures. */
+# ifndef SYS_futex_waitv
+#  define SYS_futex_waitv 449
+# endif
+# ifndef FUTEX2_SIZE_U32
+#  define FUTEX2_SIZE_U32 0x02
+# endif
+/* NUMA memory policies as defined by the kernel ABI (to avoid depending on
+   <numaif.h> provided by libnuma). */
+# ifndef MPOL_DEFAULT
+#  define MPOL_DEFAULT     0
+# endif
+# ifndef MPOL_PREFERRED
+#  define MPOL_PREFERRED   1
+# endif
+# ifndef MPOL_BIND
+#  define MPOL_BIND        2
+# endif
+# ifndef MPOL_INTERLEAVE
+#  define MPOL_INTERLEAVE  3
+# endif
+# ifndef MPOL_MF_MOVE
+#  define MPOL_MF_MOVE     (1<<1)
+# endif
+/* Flag for `mremap` (only defined by <sys/mman.h> if `_GNU_SOURCE` is
+   defined). */
+# ifndef MREMAP_MAYMOVE
+#  define MREMAP_MAYMOVE   1
+# endif
+/* Flag for `mmap` (since Linux 4.17, older kernels take the address as a
+   hint). */
+# ifndef MAP_FIXED_NOREPLACE
+#  define MAP_FIXED_NOREPLACE 0x100000
+# endif
+#endif
 
 
 /* Determine the offset of a field in a structure. */
@@ -230,6 +276,14 @@ int main(int argc, char* argv[])
   DEF_CONST(SHM_REMAP, "  = Cint(%d)");
 #endif
 
+  PUTS("\n# Commands for `shmctl` to lock/unlock a segment in memory:");
+#ifdef SHM_LOCK
+  DEF_CONST(SHM_LOCK, "   = Cint(%d)");
+#endif
+#ifdef SHM_UNLOCK
+  DEF_CONST(SHM_UNLOCK, " = Cint(%d)");
+#endif
+
   PUTS("\n# Constants for `mmap`, `msync`, etc.:");
   DEF_CONST(PROT_NONE, "     = Cint(%d)");
   DEF_CONST(PROT_READ, "     = Cint(%d)");
@@ -239,10 +293,80 @@ int main(int argc, char* argv[])
   DEF_CONST(MAP_PRIVATE, "   = Cint(%d)");
   DEF_CONST(MAP_ANONYMOUS, " = Cint(%d)"); /* FIXME: non-POSIX? */
   DEF_CONST(MAP_FIXED, "     = Cint(%d)");
+#ifdef MAP_POPULATE
+  DEF_CONST(MAP_POPULATE, "  = Cint(0x%x)"); /* Linux specific */
+#endif
+#ifdef MAP_FIXED_NOREPLACE
+  DEF_CONST(MAP_FIXED_NOREPLACE, " = Cint(0x%x)"); /* Linux specific */
+#endif
   fprintf(output, "const MAP_FAILED    = Ptr{Cvoid}(%ld)\n", (long)MAP_FAILED);
   DEF_CONST(MS_ASYNC, "      = Cint(%d)");
   DEF_CONST(MS_SYNC, "       = Cint(%d)");
   DEF_CONST(MS_INVALIDATE, " = Cint(%d)");
+#ifdef MREMAP_MAYMOVE
+  DEF_CONST(MREMAP_MAYMOVE, " = Cint(%d)"); /* Linux specific */
+#endif
+#ifdef MADV_NORMAL
+  DEF_CONST(MADV_NORMAL, "     = Cint(%d)");
+  DEF_CONST(MADV_RANDOM, "     = Cint(%d)");
+  DEF_CONST(MADV_SEQUENTIAL, " = Cint(%d)");
+  DEF_CONST(MADV_WILLNEED, "   = Cint(%d)");
+  DEF_CONST(MADV_DONTNEED, "   = Cint(%d)");
+#endif
+
+  PUTS("\n# Huge pages (Linux specific):");
+#ifdef SHM_HUGETLB
+  DEF_CONST(SHM_HUGETLB, "   = Cint(0o%o)");
+#endif
+#ifdef MADV_HUGEPAGE
+  DEF_CONST(MADV_HUGEPAGE, " = Cint(%d)");
+#endif
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_move_pages)
+  PUTS("\n# NUMA memory policy (Linux specific):");
+  fprintf(output, "const SYS_mbind       = Clong(%ld)\n", (long)SYS_mbind);
+  fprintf(output, "const SYS_move_pages  = Clong(%ld)\n", (long)SYS_move_pages);
+  DEF_CONST(MPOL_DEFAULT, "    = Cint(%d)");
+  DEF_CONST(MPOL_PREFERRED, "  = Cint(%d)");
+  DEF_CONST(MPOL_BIND, "       = Cint(%d)");
+  DEF_CONST(MPOL_INTERLEAVE, " = Cint(%d)");
+  DEF_CONST(MPOL_MF_MOVE, "    = Cuint(%d)");
+#endif
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+  PUTS("\n# Anonymous memory files (Linux specific):");
+  fprintf(output, "const SYS_memfd_create = Clong(%ld)\n",
+          (long)SYS_memfd_create);
+  DEF_CONST(MFD_CLOEXEC, "      = Cuint(0x%04x)");
+#ifdef MFD_HUGETLB
+  DEF_CONST(MFD_HUGETLB, "      = Cuint(0x%04x)");
+#endif
+#endif
+
+#if defined(__linux__) && defined(SYS_futex)
+  PUTS("\n# Fast user-space mutexes (Linux specific):");
+  fprintf(output, "const SYS_futex  = Clong(%ld)\n", (long)SYS_futex);
+  DEF_CONST(FUTEX_WAIT, " = Cint(%d)");
+  DEF_CONST(FUTEX_WAKE, " = Cint(%d)");
+  fprintf(output, "const SYS_futex_waitv = Clong(%ld)\n",
+          (long)SYS_futex_waitv);
+  DEF_CONST(FUTEX2_SIZE_U32, " = Cuint(%d)");
+#endif
+
+#if defined(__linux__) && defined(EFD_SEMAPHORE)
+  PUTS("\n# Event file descriptors (Linux specific):");
+  DEF_CONST(EFD_SEMAPHORE, " = Cint(0o%08o)");
+  DEF_CONST(EFD_NONBLOCK, "  = Cint(0o%08o)");
+  DEF_CONST(EFD_CLOEXEC, "   = Cint(0o%08o)");
+#endif
+
+#if defined(__linux__) && defined(EPOLLIN)
+  PUTS("\n# Event polling (Linux specific):");
+  DEF_CONST(EPOLL_CLOEXEC, " = Cint(0o%08o)");
+  DEF_CONST(EPOLL_CTL_ADD, " = Cint(%d)");
+  DEF_CONST(EPOLLIN, "       = Cuint(0x%04x)");
+  DEF_SIZEOF_TYPE("struct_epoll_event", struct epoll_event);
+#endif
 
   PUTS("\n# Memory page size:");
   fprintf(output, "PAGE_SIZE = %ld\n", (long)sysconf(_SC_PAGESIZE));
@@ -344,6 +468,45 @@ int main(int argc, char* argv[])
     DEF_TYPEOF_LVALUE("sem_perm_mode  ", ds.sem_perm.mode);
   }
 
+  PUTS("\n# Definitions for passing file descriptors over Unix sockets:");
+  DEF_CONST(AF_UNIX, "          = Cint(%d)");
+  DEF_CONST(SOCK_STREAM, "      = Cint(%d)");
+  DEF_CONST(SOL_SOCKET, "       = Cint(%d)");
+  DEF_CONST(SCM_RIGHTS, "       = Cint(%d)");
+#ifdef MSG_CMSG_CLOEXEC
+  DEF_CONST(MSG_CMSG_CLOEXEC, " = Cint(0x%x)");
+#endif
+  DEF_SIZEOF_TYPE("struct_iovec     ", struct iovec);
+  DEF_OFFSETOF("iov_base       ", struct iovec, iov_base);
+  DEF_OFFSETOF("iov_len        ", struct iovec, iov_len);
+  DEF_SIZEOF_TYPE("struct_msghdr    ", struct msghdr);
+  DEF_OFFSETOF("msg_iov        ", struct msghdr, msg_iov);
+  DEF_OFFSETOF("msg_iovlen     ", struct msghdr, msg_iovlen);
+  DEF_OFFSETOF("msg_control    ", struct msghdr, msg_control);
+  DEF_OFFSETOF("msg_controllen ", struct msghdr, msg_controllen);
+  DEF_OFFSETOF("cmsg_len       ", struct cmsghdr, cmsg_len);
+  DEF_OFFSETOF("cmsg_level     ", struct cmsghdr, cmsg_level);
+  DEF_OFFSETOF("cmsg_type      ", struct cmsghdr, cmsg_type);
+  {
+    struct msghdr msg;
+    struct cmsghdr cmsg;
+    union {
+      struct cmsghdr hdr;
+      char buf[CMSG_SPACE(sizeof(int))];
+    } ctl;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+    fprintf(output, "const _offsetof_cmsg_data       = %3ld\n",
+            (long)((char*)CMSG_DATA(CMSG_FIRSTHDR(&msg)) - ctl.buf));
+    fprintf(output, "const _sizeof_cmsg_space_fd     = %3lu\n",
+            (unsigned long)CMSG_SPACE(sizeof(int)));
+    fprintf(output, "const _sizeof_cmsg_len_fd       = %3lu\n",
+            (unsigned long)CMSG_LEN(sizeof(int)));
+    DEF_TYPEOF_LVALUE("msg_iovlen       ", msg.msg_iovlen);
+    DEF_TYPEOF_LVALUE("msg_controllen   ", msg.msg_controllen);
+    DEF_TYPEOF_LVALUE("cmsg_len         ", cmsg.cmsg_len);
+  }
+
   PUTS("\n# Special IPC key:");
   DEF_CONST(IPC_PRIVATE, " = _typeof_key_t(%d)");
 
@@ -18,15 +18,25 @@ export
     CLOCK_MONOTONIC,
     CLOCK_REALTIME,
     DynamicMemory,
+    EventSemaphore,
     FileDescriptor,
     FileStat,
     IPC,
     Semaphore,
+    SemaphoreSet,
     SharedMemory,
+    ShmArena,
+    ShmBroadcast,
     ShmArray,
     ShmId,
     ShmInfo,
     ShmMatrix,
+    ShmPool,
+    ShmPtr,
+    ShmQueue,
+    ShmRing,
+    ShmSeqLock,
+    ShmTripleBuffer,
     ShmVector,
     SigAction,
     SigInfo,
@@ -68,6 +78,7 @@ export
 using Printf
 using Dates
 import Dates: now
+import FileWatching
 
 using Base: elsize, tail, OneTo, throw_boundserror, @propagate_inbounds
 
@@ -84,9 +95,24 @@ include(joinpath("..", "deps", "deps.jl"))
 include("types.jl")
 include("wrappedarrays.jl")
 include("unix.jl")
+include("atomics.jl")
 include("utils.jl")
+include("cache.jl")
 include("shm.jl")
+include("numa.jl")
+include("arena.jl")
+include("pool.jl")
+include("shmptr.jl")
+include("ring.jl")
+include("queue.jl")
+include("broadcast.jl")
+include("seqlock.jl")
+include("triplebuffer.jl")
+include("futex.jl")
 include("semaphores.jl")
+include("semsets.jl")
+include("eventfd.jl")
+include("waitany.jl")
 include("signals.jl")
 include("locks.jl")
 
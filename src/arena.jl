@@ -0,0 +1,209 @@
+#
+# arena.jl --
+#
+# Lock-free allocator of blocks of memory in shared memory for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmArena(mem, len; offset=0) -> arena
+```
+
+creates a new arena, that is an allocator of blocks of memory, using `len`
+bytes of memory object `mem` at relative position (in bytes) specified by
+keyword `offset`.  The memory object is typically a [`SharedMemory`](@ref) so
+that the blocks can be used by several processes.  The address of the arena
+must be a multiple of 16 bytes.
+
+```julia
+ShmArena(mem; offset=0) -> arena
+```
+
+yields an instance of `ShmArena` associated with an existing arena stored by
+memory object `mem` at relative position given by keyword `offset`.  This is
+how other processes attach the arena.
+
+Blocks are allocated and released by:
+
+```julia
+off = IPC.alloc!(arena, n)
+IPC.free!(arena, off)
+```
+
+where `n` is the number of needed bytes and `off` is the offset (in bytes) of
+the block relative to `pointer(mem)`.  Since offsets, not addresses, are
+handed out, they can be stored in shared memory and resolved by any process:
+`pointer(arena, off)` yields the address of the block in the caller address
+space.  For instance, a shared array may be stored in a block with:
+
+```julia
+off = IPC.alloc!(arena, sizeof(T)*prod(dims))
+A = WrappedArray(mem, T, dims; offset=off)
+```
+
+Blocks are aligned on 16 bytes.  An `OutOfMemoryError` is thrown if the arena
+is exhausted.  Freeing a block which is not allocated throws an
+`ArgumentError`.
+
+Blocks are organized in power of 2 size classes.  Each class has its own
+lock-free free list (a Treiber stack with a tagged head to avoid the ABA
+problem) and new blocks are carved out of the remaining space by atomically
+bumping a pointer.  Allocation and release of blocks are thus lock-free and
+may be done concurrently by any threads of any processes.  Released blocks are
+recycled for the same size class but never merged.
+
+"""
+function ShmArena(mem::M, len::Integer; offset::Integer = 0) where {M}
+    base = _shared_address(mem, offset, len, _ARENA_GRANULE)
+    len ≥ _ARENA_HEADER_SIZE + 2*_ARENA_GRANULE ||
+        throw_argument_error("arena is too small")
+    div(len, _ARENA_GRANULE) ≤ typemax(UInt32) ||
+        throw_argument_error("arena is too large")
+    ccall(:memset, Ptr{Cvoid}, (Ptr{Cvoid}, Cint, Csize_t),
+          base, 0, _ARENA_HEADER_SIZE)
+    _poke!(UInt64, base + _ARENA_SIZE_OFFSET, len)
+    _atomic_store!(Ptr{UInt64}(base + _ARENA_TOP_OFFSET), _ARENA_HEADER_SIZE,
+                   :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _ARENA_MAGIC, :release)
+    return ShmArena{M}(mem, offset)
+end
+
+function ShmArena(mem::M; offset::Integer = 0) where {M}
+    base = _shared_address(mem, offset, _ARENA_HEADER_SIZE, _ARENA_GRANULE)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _ARENA_MAGIC ||
+        throw_argument_error("no arena at given offset")
+    _shared_address(mem, offset, _peek(UInt64, base + _ARENA_SIZE_OFFSET),
+                    _ARENA_GRANULE)
+    return ShmArena{M}(mem, offset)
+end
+
+Base.pointer(arena::ShmArena) = pointer(arena.mem) + arena.off
+Base.pointer(arena::ShmArena, off::Integer) = pointer(arena.mem) + off
+Base.sizeof(arena::ShmArena) =
+    Int(_peek(UInt64, pointer(arena) + _ARENA_SIZE_OFFSET))
+
+"""
+```julia
+IPC.alloc!(arena, n) -> off
+```
+
+allocates a block of at least `n` bytes in `arena` and yields its offset
+relative to the memory object of the arena.
+
+See [`ShmArena`](@ref) for details.
+
+"""
+function alloc!(arena::ShmArena, n::Integer)
+    n ≥ 0 || throw_argument_error("invalid number of bytes (", n, ")")
+    k = _arena_class(n)
+    base = pointer(arena)
+
+    # Attempt to pop a released block from the free list of the class.  The
+    # link to the next block may be garbage if the block has been popped by
+    # someone else meanwhile, but then the tag has changed and the CAS fails.
+    head = Ptr{UInt64}(base + _ARENA_HEADS_OFFSET + 8*k)
+    while true
+        h = _atomic_load(head, :acquire)
+        idx = h & 0xffffffff
+        idx == 0 && break
+        blk = base + _ARENA_GRANULE*Int(idx)
+        nxt = _atomic_load(Ptr{UInt64}(blk + 8), :monotonic)
+        if _atomic_cas!(head, h, _arena_tag(h, nxt))[2]
+            _atomic_store!(Ptr{UInt64}(blk), _ARENA_ALLOCATED | k, :monotonic)
+            return arena.off + _ARENA_GRANULE*Int(idx) + _ARENA_GRANULE
+        end
+        _cpu_pause()
+    end
+
+    # Carve a new block out of the remaining space.
+    siz = UInt64(_ARENA_GRANULE) << k
+    len = _peek(UInt64, base + _ARENA_SIZE_OFFSET)
+    top = Ptr{UInt64}(base + _ARENA_TOP_OFFSET)
+    t = _atomic_load(top, :monotonic)
+    while true
+        t + siz ≤ len || throw(OutOfMemoryError())
+        t, ok = _atomic_cas!(top, t, t + siz, :monotonic)
+        ok && break
+    end
+    blk = base + Int(t)
+    _atomic_store!(Ptr{UInt64}(blk), _ARENA_ALLOCATED | k, :monotonic)
+    return arena.off + Int(t) + _ARENA_GRANULE
+end
+
+"""
+```julia
+IPC.free!(arena, off)
+```
+
+releases the block at offset `off` previously allocated in `arena` by
+[`IPC.alloc!`](@ref).
+
+See [`ShmArena`](@ref) for details.
+
+"""
+function free!(arena::ShmArena, off::Integer)
+    base = pointer(arena)
+    rel = Int(off) - arena.off - _ARENA_GRANULE
+    (rel ≥ _ARENA_HEADER_SIZE && rel % _ARENA_GRANULE == 0 &&
+     rel < _peek(UInt64, base + _ARENA_SIZE_OFFSET)) ||
+         throw_argument_error("invalid offset of block in arena")
+    blk = base + rel
+
+    # Atomically clear the allocated bit to detect double release.
+    w = _atomic_load(Ptr{UInt64}(blk), :monotonic)
+    ((w & _ARENA_ALLOCATED) != 0 &&
+     _atomic_cas!(Ptr{UInt64}(blk), w, w & ~_ARENA_ALLOCATED)[2]) ||
+         throw_argument_error("block is not allocated")
+    k = Int(w & ~_ARENA_ALLOCATED)
+    0 ≤ k < _ARENA_NCLASSES || throw_argument_error("corrupted arena")
+
+    # Push the block on the free list of its class.
+    head = Ptr{UInt64}(base + _ARENA_HEADS_OFFSET + 8*k)
+    idx = UInt64(div(rel, _ARENA_GRANULE))
+    h = _atomic_load(head, :monotonic)
+    while true
+        _atomic_store!(Ptr{UInt64}(blk + 8), h & 0xffffffff, :monotonic)
+        h, ok = _atomic_cas!(head, h, _arena_tag(h, idx), :release)
+        ok && break
+    end
+    nothing
+end
+
+# Layout of an arena.  The header stores the magic number, the size of the
+# arena, the offset of the first never allocated byte and, on the next cache
+# line, the heads of the free lists.  Each head stores the index (in granules
+# relative to the base of the arena) of the first free block of the class in
+# its 32 least significant bits and a tag incremented by every change in its
+# 32 most significant bits.  Each block starts with one granule storing its
+# size class with an allocated bit and the index of the next free block.
+const _ARENA_MAGIC = 0x414e455241435049 # "IPCARENA" in little endian order
+const _ARENA_GRANULE = 16
+const _ARENA_NCLASSES = 32
+const _ARENA_SIZE_OFFSET = 8
+const _ARENA_TOP_OFFSET = 16
+const _ARENA_HEADS_OFFSET = 64
+const _ARENA_HEADER_SIZE = _ARENA_HEADS_OFFSET + 8*_ARENA_NCLASSES
+const _ARENA_ALLOCATED = UInt64(1) << 63
+
+# Yield the new value of a free list head, `h` being the former value and
+# `idx` the index of the new first block.
+@inline _arena_tag(h::UInt64, idx::UInt64) =
+    (((h >> 32) + 1) << 32) | (idx & 0xffffffff)
+
+# Yield the size class for `n` bytes, that is the smallest `k` such that a
+# block of `16 << k` bytes (including its header) has at least `n` bytes (and
+# at least one byte so that distinct blocks have distinct offsets).
+function _arena_class(n::Integer)
+    g = cld(max(Int(n), 1) + _ARENA_GRANULE, _ARENA_GRANULE)
+    k = 64 - leading_zeros(UInt64(g - 1))
+    k < _ARENA_NCLASSES || throw(OutOfMemoryError())
+    return k
+end
@@ -0,0 +1,258 @@
+#
+# atomics.jl --
+#
+# Atomic operations on memory shared between processes for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+# Atomic operations are implemented by the intrinsics of Julia (version 1.7
+# or more recent) which directly operate on pointers.  They are lock-free for
+# bits types of 1, 2, 4 or 8 bytes and are thus usable on memory shared
+# between processes.  Memory orderings are specified by the same symbols as
+# for Julia atomics: `:monotonic`, `:acquire`, `:release`, `:acquire_release`
+# and `:sequentially_consistent`.
+
+# Types of values for which atomic operations are supported.
+const AtomicTypes = Union{Int8,Int16,Int32,Int64,UInt8,UInt16,UInt32,UInt64,
+                          Float32,Float64}
+
+# Yield the value stored at address `ptr`.
+@inline _atomic_load(ptr::Ptr{T}, order::Symbol = :acquire) where {T} =
+    Core.Intrinsics.atomic_pointerref(ptr, order)::T
+
+# Store value `val` at address `ptr`.
+@inline function _atomic_store!(ptr::Ptr{T}, val,
+                                order::Symbol = :release) where {T}
+    Core.Intrinsics.atomic_pointerset(ptr, convert(T, val), order)
+    nothing
+end
+
+# Store value `val` at address `ptr` and yield the previous value.
+@inline _atomic_xchg!(ptr::Ptr{T}, val,
+                      order::Symbol = :acquire_release) where {T} =
+    Core.Intrinsics.atomic_pointerswap(ptr, convert(T, val), order)::T
+
+# Add `val` to the value stored at address `ptr` and yield the previous value.
+@inline _atomic_add!(ptr::Ptr{T}, val,
+                     order::Symbol = :acquire_release) where {T} =
+    Core.Intrinsics.atomic_pointermodify(ptr, +, convert(T, val), order)[1]::T
+
+# Compare and swap: if the value stored at address `ptr` is `cmp`, replace it
+# by `val`.  Yield a 2-tuple with the previous value and whether the
+# replacement took place.  The ordering on failure is the strongest ordering
+# allowed by the ordering on success.
+@inline function _atomic_cas!(ptr::Ptr{T}, cmp, val,
+                              order::Symbol = :acquire_release,
+                              failorder::Symbol = _failure_order(order)) where {T}
+    r = Core.Intrinsics.atomic_pointerreplace(ptr, convert(T, cmp),
+                                              convert(T, val),
+                                              order, failorder)
+    return (r[1]::T, r[2]::Bool)
+end
+
+# Memory fence with ordering `order`.
+@inline _atomic_fence(order::Symbol = :sequentially_consistent) =
+    Core.Intrinsics.atomic_fence(order)
+
+_failure_order(order::Symbol) =
+    (order === :acquire_release ? :acquire :
+     order === :release         ? :monotonic : order)
+
+# Hint the processor that the caller is spinning.
+@inline _cpu_pause() = ccall(:jl_cpu_pause, Cvoid, ())
+
+# Number of attempts during which a waiting loop pauses the processor before
+# yielding to other tasks.
+const _SPIN_LIMIT = 100
+
+# Wait a bit in a loop polling for a condition, `n` being the number of
+# previous attempts.  Yields the incremented number of attempts.
+@inline function _backoff(n::Int)
+    if n < _SPIN_LIMIT
+        _cpu_pause()
+    else
+        yield()
+    end
+    return n + 1
+end
+
+"""
+```julia
+IPC.atomic_load(A, i, order=:sequentially_consistent) -> val
+IPC.atomic_load(mem, T, off, order=:sequentially_consistent) -> val
+```
+
+atomically loads the `i`-th element (a linear index) of the wrapped array `A`,
+or the value of type `T` stored at offset `off` (in bytes) in the memory object
+`mem` (e.g. a [`SharedMemory`](@ref)).  Argument `order` specifies the memory
+ordering with the same symbols as for Julia atomics: `:monotonic`, `:acquire`,
+`:release`, `:acquire_release` or `:sequentially_consistent`.
+
+Atomic operations are lock-free, do not call the system and can be used to
+implement counters, flags or histograms shared between processes.  The
+following operations are available:
+
+```julia
+IPC.atomic_load(A, i, order) -> val
+IPC.atomic_store!(A, i, val, order) -> nothing
+IPC.atomic_add!(A, i, val, order) -> old
+IPC.atomic_xchg!(A, i, val, order) -> old
+IPC.atomic_cas!(A, i, cmp, val, order, failorder) -> (old, success)
+```
+
+where `A, i` may be replaced by `mem, T, off` and where `old` is the value
+stored before the operation.  `IPC.atomic_cas!` replaces the value by `val`
+only if it is equal to `cmp`, `failorder` is the memory ordering if the value
+is not replaced, by default the strongest one allowed by `order`.  The default
+ordering is `:sequentially_consistent` for all operations.
+
+The element type must be one of the integer or floating-point types of 1, 2,
+4 or 8 bytes supported by wrapped arrays and the address of the value must be
+a multiple of its size.
+
+"""
+atomic_load(A::WrappedArray{T}, i::Integer,
+            order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve A _atomic_load(_atomic_pointer(A, i), order)
+
+atomic_load(mem, ::Type{T}, off::Integer,
+            order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve mem _atomic_load(_atomic_pointer(mem, T, off), order)
+
+"""
+```julia
+IPC.atomic_store!(A, i, val, order=:sequentially_consistent)
+IPC.atomic_store!(mem, T, off, val, order=:sequentially_consistent)
+```
+
+atomically stores `val` in the `i`-th element of the wrapped array `A` or at
+offset `off` (in bytes) in the memory object `mem` as a value of type `T`.
+
+See [`IPC.atomic_load`](@ref) for details.
+
+"""
+atomic_store!(A::WrappedArray{T}, i::Integer, val,
+              order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve A _atomic_store!(_atomic_pointer(A, i), val, order)
+
+atomic_store!(mem, ::Type{T}, off::Integer, val,
+              order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve mem _atomic_store!(_atomic_pointer(mem, T, off), val, order)
+
+"""
+```julia
+IPC.atomic_add!(A, i, val, order=:sequentially_consistent) -> old
+IPC.atomic_add!(mem, T, off, val, order=:sequentially_consistent) -> old
+```
+
+atomically adds `val` to the `i`-th element of the wrapped array `A` or to the
+value of type `T` at offset `off` (in bytes) in the memory object `mem` and
+yields the previous value.
+
+See [`IPC.atomic_load`](@ref) for details.
+
+"""
+atomic_add!(A::WrappedArray{T}, i::Integer, val,
+            order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve A _atomic_add!(_atomic_pointer(A, i), val, order)
+
+atomic_add!(mem, ::Type{T}, off::Integer, val,
+            order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve mem _atomic_add!(_atomic_pointer(mem, T, off), val, order)
+
+"""
+```julia
+IPC.atomic_xchg!(A, i, val, order=:sequentially_consistent) -> old
+IPC.atomic_xchg!(mem, T, off, val, order=:sequentially_consistent) -> old
+```
+
+atomically replaces the `i`-th element of the wrapped array `A` or the value
+of type `T` at offset `off` (in bytes) in the memory object `mem` by `val` and
+yields the previous value.
+
+See [`IPC.atomic_load`](@ref) for details.
+
+"""
+atomic_xchg!(A::WrappedArray{T}, i::Integer, val,
+             order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve A _atomic_xchg!(_atomic_pointer(A, i), val, order)
+
+atomic_xchg!(mem, ::Type{T}, off::Integer, val,
+             order::Symbol = :sequentially_consistent) where {T} =
+    GC.@preserve mem _atomic_xchg!(_atomic_pointer(mem, T, off), val, order)
+
+"""
+```julia
+IPC.atomic_cas!(A, i, cmp, val, order=:sequentially_consistent,
+                failorder) -> (old, success)
+IPC.atomic_cas!(mem, T, off, cmp, val, order=:sequentially_consistent,
+                failorder) -> (old, success)
+```
+
+atomically replaces the `i`-th element of the wrapped array `A` or the value
+of type `T` at offset `off` (in bytes) in the memory object `mem` by `val` if
+it is equal to `cmp`.  Yields the previous value and whether the replacement
+took place.
+
+See [`IPC.atomic_load`](@ref) for details.
+
+"""
+atomic_cas!(A::WrappedArray{T}, i::Integer, cmp, val,
+            order::Symbol = :sequentially_consistent,
+            failorder::Symbol = _failure_order(order)) where {T} =
+    GC.@preserve A _atomic_cas!(_atomic_pointer(A, i), cmp, val,
+                                order, failorder)
+
+atomic_cas!(mem, ::Type{T}, off::Integer, cmp, val,
+            order::Symbol = :sequentially_consistent,
+            failorder::Symbol = _failure_order(order)) where {T} =
+    GC.@preserve mem _atomic_cas!(_atomic_pointer(mem, T, off), cmp, val,
+                                  order, failorder)
+
+# Yield the address of a value for an atomic operation after checking the
+# type, the bounds and the alignment.
+function _atomic_pointer(A::WrappedArray{T}, i::Integer) where {T}
+    _check_atomic_type(T)
+    checkbounds(A, i)
+    return _check_atomic_alignment(pointer(A, i))
+end
+
+function _atomic_pointer(mem, ::Type{T}, off::Integer) where {T}
+    _check_atomic_type(T)
+    0 ≤ off ≤ sizeof(mem) - sizeof(T) ||
+        throw_argument_error("out of range offset (", off, ")")
+    return _check_atomic_alignment(Ptr{T}(pointer(mem) + off))
+end
+
+_check_atomic_type(::Type{T}) where {T} =
+    T <: AtomicTypes ||
+    throw_argument_error("atomic operations are not supported for type ", T)
+
+function _check_atomic_alignment(ptr::Ptr{T}) where {T}
+    rem(UInt(ptr), sizeof(T)) == 0 ||
+        throw_argument_error("address is not aligned for atomic operations")
+    return ptr
+end
+
+# Yield the address of a shared structure of `len` bytes at offset `off` (in
+# bytes) in the memory object `mem` after checking that it fits in `mem` and
+# that its address is a multiple of `align` bytes (a cache line by default).
+function _shared_address(mem, off::Integer, len::Integer,
+                         align::Integer = 64)::Ptr{Cvoid}
+    off ≥ 0 || throw_argument_error("offset must be nonnegative (", off, ")")
+    ptr, siz = get_memory_parameters(mem)
+    siz ≥ off + len ||
+        throw_argument_error("not enough memory at given offset")
+    ptr += off
+    rem(convert(Int, ptr), align) == 0 ||
+        throw_argument_error("address must be a multiple of ", align,
+                             " bytes")
+    return ptr
+end
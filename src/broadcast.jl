@@ -0,0 +1,296 @@
+#
+# broadcast.jl --
+#
+# Single-writer/multiple-reader broadcast rings in shared memory for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmBroadcast(mem, slotsize, nslots; offset=0) -> bc
+```
+
+creates a new broadcast ring of `nslots` slots of `slotsize` bytes each stored
+by memory object `mem` at relative position (in bytes) specified by keyword
+`offset`.  The memory object is typically a [`SharedMemory`](@ref) so that
+frames published by a single writer can be read by any number of readers in
+other processes.  The number of slots must be a power of 2.  The number of
+bytes needed by the ring is given by `sizeof(ShmBroadcast, slotsize,
+nslots)`.  The returned object is meant to be used by the writer.
+
+```julia
+ShmBroadcast(mem; offset=0) -> bc
+```
+
+yields an instance of `ShmBroadcast` associated with an existing broadcast ring
+stored by memory object `mem` at relative position given by keyword `offset`.
+This is how readers attach the ring.  Each reader must have its own instance
+which stores its cursor (the number of the next frame to read) in local
+memory.  The cursor of a new reader is set so that it only reads frames
+published after it attached the ring.
+
+The ring may also be directly stored in new shared memory identified by `id`
+(see [`SharedMemory`](@ref) for a description of `id` and for keywords `kwds`)
+and retrieved by readers with:
+
+```julia
+ShmBroadcast(id, slotsize, nslots; kwds...) -> bc # create
+ShmBroadcast(id; kwds...) -> bc                   # attach
+```
+
+The writer publishes a frame by writing it directly in the next slot:
+
+```julia
+A = IPC.claim!(bc)       # get a vector of bytes to write the next frame
+...                      # write the frame in A
+IPC.publish!(bc, nbytes) # publish the `nbytes` first bytes of A
+```
+
+A reader reads frames by:
+
+```julia
+A = IPC.tryfetch(bc, T=UInt8) # get the next frame or nothing
+A = fetch(bc, T=UInt8)        # get the next frame, blocking if none
+...                           # use the contents of A
+if IPC.validate!(bc)
+    ...                       # contents of A was valid
+end
+```
+
+where `A` is a [`WrappedArray`](@ref) vector with elements of type `T`
+directly sharing the memory of the slot (no copies are involved).  The frame
+may be overwritten by the writer at any time, so the reader must call
+`IPC.validate!(bc)` after having used the contents of `A` (and copied anything
+it wants to keep) to check that the frame has not been overwritten
+meanwhile; this also moves the cursor of the reader to the next frame.  A
+reader that is too slow is lapped by the writer: it skips the frames that have
+been overwritten and resumes with the most recent frame.  `IPC.dropped(bc)`
+yields the number of frames missed by a reader so far.
+
+The writer never waits for the readers and readers do not write to the shared
+memory, so readers do not slow down the writer nor other readers.  Each slot
+has a sequence number which is odd while the writer is writing the slot and
+even when the frame is published, this is how readers detect overwritten
+frames.
+
+"""
+function ShmBroadcast(mem::M, slotsize::Integer, nslots::Integer;
+                      offset::Integer = 0) where {M}
+    slotsize ≥ 1 || throw_argument_error("invalid slot size (", slotsize, ")")
+    nslots ≥ 1 && ispow2(nslots) ||
+        throw_argument_error("number of slots must be a power of 2 (",
+                             nslots, ")")
+    base = _shared_address(mem, offset,
+                           sizeof(ShmBroadcast, slotsize, nslots))
+    _poke!(UInt64, base + 8, slotsize)
+    _poke!(UInt64, base + 16, nslots)
+    stride = _bcast_stride(slotsize)
+    for i in 0:nslots-1
+        _atomic_store!(Ptr{UInt64}(base + _BCAST_SLOTS_OFFSET + stride*i), 0,
+                       :monotonic)
+    end
+    _atomic_store!(Ptr{UInt64}(base + _BCAST_INDEX_OFFSET), 0, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _BCAST_MAGIC, :release)
+    return ShmBroadcast{M}(mem, offset, slotsize, nslots, 0, 0)
+end
+
+function ShmBroadcast(mem::M; offset::Integer = 0) where {M}
+    base = _shared_address(mem, offset, _BCAST_SLOTS_OFFSET)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _BCAST_MAGIC ||
+        throw_argument_error("no broadcast ring at given offset")
+    slotsize = Int(_peek(UInt64, base + 8))
+    nslots = Int(_peek(UInt64, base + 16))
+    _shared_address(mem, offset, sizeof(ShmBroadcast, slotsize, nslots))
+    next = _atomic_load(Ptr{UInt64}(base + _BCAST_INDEX_OFFSET), :acquire)
+    return ShmBroadcast{M}(mem, offset, slotsize, nslots, next, 0)
+end
+
+function ShmBroadcast(id::Union{AbstractString,ShmId,Key,File,
+                                Type{FileDescriptor}},
+                      slotsize::Integer, nslots::Integer; kwds...)
+    mem = SharedMemory(id, sizeof(ShmBroadcast, slotsize, nslots); kwds...)
+    return ShmBroadcast(mem, slotsize, nslots)
+end
+
+ShmBroadcast(id::Union{AbstractString,ShmId,Key,File,FileDescriptor};
+             kwds...) = ShmBroadcast(SharedMemory(id; kwds...))
+
+Base.sizeof(::Type{<:ShmBroadcast}, slotsize::Integer, nslots::Integer) =
+    _BCAST_SLOTS_OFFSET + _bcast_stride(slotsize)*Int(nslots)
+
+Base.pointer(bc::ShmBroadcast) = pointer(bc.mem) + bc.off
+capacity(bc::ShmBroadcast) = bc.nslots
+
+"""
+```julia
+IPC.claim!(bc) -> A
+```
+
+yields a vector of bytes sharing the memory of the next slot of the broadcast
+ring `bc` for the writer to store the next frame.  The frame is published by
+[`IPC.publish!`](@ref).
+
+See [`ShmBroadcast`](@ref) for details.
+
+"""
+function claim!(bc::ShmBroadcast)
+    base = pointer(bc)
+    n = _atomic_load(_bcast_index(base), :monotonic)
+    # Mark the slot as being written before modifying its contents.
+    _atomic_store!(_bcast_seq(bc, base, n), 2n + 1, :monotonic)
+    _atomic_fence(:release)
+    return WrappedArray(bc.mem, UInt8, bc.slotsize;
+                        offset = _bcast_data_offset(bc, n))
+end
+
+"""
+```julia
+IPC.publish!(bc, nbytes=IPC.slotsize(bc)) -> bc
+```
+
+publishes the frame of `nbytes` bytes written by the writer in the slot of
+the broadcast ring `bc` returned by the last call to [`IPC.claim!`](@ref).
+
+See [`ShmBroadcast`](@ref) for details.
+
+"""
+function publish!(bc::ShmBroadcast, nbytes::Integer = bc.slotsize)
+    0 ≤ nbytes ≤ bc.slotsize ||
+        throw_argument_error("invalid number of bytes (", nbytes, ")")
+    base = pointer(bc)
+    index = _bcast_index(base)
+    n = _atomic_load(index, :monotonic)
+    seq = _bcast_seq(bc, base, n)
+    _atomic_load(seq, :monotonic) == 2n + 1 ||
+        throw_error_exception("no slot has been claimed")
+    _atomic_store!(seq + 8, nbytes, :monotonic)
+    _atomic_store!(seq, 2n + 2, :release)
+    _atomic_store!(index, n + 1, :release)
+    return bc
+end
+
+"""
+```julia
+IPC.tryfetch(bc, T=UInt8) -> A_or_nothing
+```
+
+yields a vector of values of type `T` sharing the memory of the next frame to
+be read in the broadcast ring `bc` or `nothing` if no new frame has been
+published.  The frame is not copied, so [`IPC.validate!`](@ref) must be called
+after having used it.
+
+See [`ShmBroadcast`](@ref) for details.
+
+"""
+function tryfetch(bc::ShmBroadcast, ::Type{T} = UInt8) where {T}
+    base = pointer(bc)
+    while true
+        w = _atomic_load(_bcast_index(base), :acquire)
+        n = bc.next
+        n < w || return nothing
+        if w - n > bc.nslots
+            # The reader has been lapped, skip to the most recent frame.
+            _bcast_skip!(bc, w - 1)
+            continue
+        end
+        seq = _bcast_seq(bc, base, n)
+        if _atomic_load(seq, :acquire) == 2n + 2
+            len = Int(_atomic_load(seq + 8, :monotonic))
+            return WrappedArray(bc.mem, T, div(len, sizeof(T));
+                                offset = _bcast_data_offset(bc, n))
+        end
+        # The frame is being overwritten, skip it.
+        _bcast_skip!(bc, n + 1)
+    end
+end
+
+function Base.fetch(bc::ShmBroadcast, ::Type{T} = UInt8) where {T}
+    spins = 0
+    while true
+        A = tryfetch(bc, T)
+        A === nothing || return A
+        spins = _backoff(spins)
+    end
+end
+
+"""
+```julia
+IPC.validate!(bc) -> bool
+```
+
+yields whether the frame last fetched by the reader of the broadcast ring `bc`
+has not been overwritten by the writer and moves the cursor of the reader to
+the next frame.
+
+See [`ShmBroadcast`](@ref) for details.
+
+"""
+function validate!(bc::ShmBroadcast)
+    # Make sure that the reading of the frame is done before checking the
+    # sequence number.
+    _atomic_fence(:acquire)
+    n = bc.next
+    valid = (_atomic_load(_bcast_seq(bc, pointer(bc), n), :monotonic) ==
+             2n + 2)
+    if valid
+        bc.next = n + 1
+    else
+        _bcast_skip!(bc, n + 1)
+    end
+    return valid
+end
+
+"""
+```julia
+IPC.dropped(bc) -> n
+```
+
+yields the number of frames missed so far by the reader of the broadcast ring
+`bc` because it has been lapped by the writer.
+
+See [`ShmBroadcast`](@ref) for details.
+
+"""
+dropped(bc::ShmBroadcast) = bc.dropped
+
+slotsize(bc::ShmBroadcast) = bc.slotsize
+
+# Layout of a broadcast ring.  The header stores the magic number, the size
+# and the number of the slots and, on the next cache line, the number of
+# published frames.  The header is followed by the slots, each slot starts
+# with a cache line storing its sequence number and the size of the frame it
+# stores.  The sequence number is `2n + 1` while frame `n` is being written in
+# the slot and `2n + 2` when frame `n` is published.
+const _BCAST_MAGIC = 0x5453414342435049 # "IPCBCAST" in little endian order
+const _BCAST_INDEX_OFFSET = 64
+const _BCAST_SLOTS_OFFSET = 128
+const _BCAST_SLOT_HEADER = 64
+
+_bcast_stride(slotsize::Integer) =
+    _BCAST_SLOT_HEADER + roundup(Int(slotsize), 64)
+
+@inline _bcast_index(base::Ptr) = Ptr{UInt64}(base + _BCAST_INDEX_OFFSET)
+
+@inline _bcast_slot_offset(bc::ShmBroadcast, n::UInt64) =
+    _BCAST_SLOTS_OFFSET +
+    _bcast_stride(bc.slotsize)*Int(n & UInt64(bc.nslots - 1))
+
+@inline _bcast_seq(bc::ShmBroadcast, base::Ptr, n::UInt64) =
+    Ptr{UInt64}(base + _bcast_slot_offset(bc, n))
+
+@inline _bcast_data_offset(bc::ShmBroadcast, n::UInt64) =
+    bc.off + _bcast_slot_offset(bc, n) + _BCAST_SLOT_HEADER
+
+# Move the cursor of a reader to frame `n` and account for missed frames.
+function _bcast_skip!(bc::ShmBroadcast, n::UInt64)
+    bc.dropped += Int(n - bc.next)
+    bc.next = n
+    nothing
+end
@@ -0,0 +1,101 @@
+#
+# cache.jl --
+#
+# Process-wide cache of handles to named shared memory objects and semaphores
+# for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+IPC.cachestats() -> (hits = ..., misses = ...)
+```
+
+yields the number of hits and misses of the process-wide cache of handles.
+
+```julia
+IPC.clearcache!()
+```
+
+empties the process-wide cache of handles and resets its counters.  Objects
+already returned are not affected.
+
+The cache of handles is used when an existing named shared memory object, a
+System V shared memory segment or a named semaphore is retrieved with keyword
+`cache=true`, for instance:
+
+```julia
+SharedMemory(name; cache=true)
+SharedMemory(id; readonly=false, cache=true)
+Semaphore(name; cache=true)
+```
+
+If this process already has a live object for the same name (or identifier)
+and access mode, this object is returned without any system call (the other
+keywords are then ignored).  Otherwise, a new object is created as usual and
+recorded in the cache.  Objects created with keyword `cache=true` (e.g., by
+`SharedMemory(name, len; cache=true)`) are also recorded in the cache.  The
+cache only holds weak references, so it does not prevent objects from being
+finalized.
+
+Note that the cache has no means to figure out whether a named object has been
+removed and another one created with the same name since it was recorded; in
+that case, call `IPC.clearcache!()`.
+
+"""
+cachestats() = (hits = _HANDLE_CACHE_HITS[], misses = _HANDLE_CACHE_MISSES[])
+
+function clearcache!()
+    lock(_HANDLE_CACHE_LOCK) do
+        empty!(_HANDLE_CACHE)
+        _HANDLE_CACHE_HITS[] = 0
+        _HANDLE_CACHE_MISSES[] = 0
+    end
+    nothing
+end
+
+@doc @doc(cachestats) clearcache!
+
+# The cache is indexed by the kind of object, its name or identifier and
+# whether it is open for read-only access.
+const _HandleKey = Tuple{Symbol,Any,Bool}
+const _HANDLE_CACHE = Dict{_HandleKey,WeakRef}()
+const _HANDLE_CACHE_LOCK = ReentrantLock()
+const _HANDLE_CACHE_HITS = Threads.Atomic{Int}(0)
+const _HANDLE_CACHE_MISSES = Threads.Atomic{Int}(0)
+
+# Yield the live object recorded in the cache for the given kind, name or
+# identifier and access, or call `f()` to create a new one and record it.  The
+# lock is held while creating the object so that the same object is not open
+# twice by concurrent threads.
+function _cached(f::Function, kind::Symbol, id, readonly::Bool)
+    key = (kind, id, readonly)
+    lock(_HANDLE_CACHE_LOCK) do
+        ref = get(_HANDLE_CACHE, key, nothing)
+        if ref !== nothing && (obj = ref.value) !== nothing
+            Threads.atomic_add!(_HANDLE_CACHE_HITS, 1)
+            return obj
+        end
+        Threads.atomic_add!(_HANDLE_CACHE_MISSES, 1)
+        # Forget about finalized objects, then record the new one.
+        filter!(p -> p.second.value !== nothing, _HANDLE_CACHE)
+        obj = f()
+        _HANDLE_CACHE[key] = WeakRef(obj)
+        return obj
+    end
+end
+
+# Record a newly created object in the cache.
+function _cache!(obj, kind::Symbol, id, readonly::Bool)
+    lock(_HANDLE_CACHE_LOCK) do
+        _HANDLE_CACHE[(kind, id, readonly)] = WeakRef(obj)
+    end
+    return obj
+end
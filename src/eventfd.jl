@@ -0,0 +1,102 @@
+#
+# eventfd.jl --
+#
+# Semaphores based on event file descriptors for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+EventSemaphore(value=0) -> sem
+```
+
+creates a new semaphore with initial value `value` and based on an event file
+descriptor (see `eventfd(2)`).  Such a semaphore can be used with the same
+methods as a [`Semaphore`](@ref):
+
+```julia
+post(sem)            # increment the semaphore
+wait(sem)            # decrement the semaphore, blocking if zero
+timedwait(sem, secs) # idem but waiting no longer than `secs` seconds
+trywait(sem)         # attempt to decrement the semaphore without blocking
+```
+
+but waiting on an event semaphore is done by the event loop of Julia (see
+`FileWatching.poll_fd`) so that only the calling task is suspended while other
+tasks keep running on the calling thread; no threads are ever blocked.
+
+An event semaphore is shared with other processes by sending its file
+descriptor (see [`IPC.sendfd`](@ref)), the other process retrieves the
+semaphore by:
+
+```julia
+sem = EventSemaphore(IPC.recvfd(sock))
+```
+
+The file descriptor of the semaphore is given by `fd(sem)` and is closed when
+the semaphore is garbage collected or by calling `close(sem)`.  Event
+semaphores are only available on Linux.
+
+See also: [`Semaphore`](@ref), [`post`](@ref), [`wait`](@ref),
+          [`timedwait`](@ref), [`trywait`](@ref).
+
+"""
+function EventSemaphore(value::Integer = 0)
+    0 ≤ value ≤ typemax(Cuint) ||
+        throw_argument_error("invalid semaphore value (", value, ")")
+    fd = _eventfd_semaphore(value)
+    fd == -1 && throw_system_error("eventfd")
+    return EventSemaphore(finalizer(_close, FileDescriptor(fd)))
+end
+
+Base.fd(sem::EventSemaphore) = fd(sem.fd)
+Base.close(sem::EventSemaphore) = close(sem.fd)
+Base.isopen(sem::EventSemaphore) = isopen(sem.fd)
+_fd(sem::EventSemaphore) = fd(sem)
+
+function post(sem::EventSemaphore)
+    buf = Ref{UInt64}(1)
+    while GC.@preserve(buf, _write(fd(sem), _pointer(buf), 8)) != 8
+        code = Libc.errno()
+        code == Libc.EINTR || throw_system_error("write", code)
+    end
+    nothing
+end
+
+function trywait(sem::EventSemaphore)
+    buf = Ref{UInt64}(0)
+    while GC.@preserve(buf, _read(fd(sem), _pointer(buf), 8)) != 8
+        code = Libc.errno()
+        code == Libc.EAGAIN && return false
+        code == Libc.EINTR || throw_system_error("read", code)
+    end
+    return true
+end
+
+function Base.wait(sem::EventSemaphore)
+    while !trywait(sem)
+        FileWatching.poll_fd(RawFD(fd(sem)); readable = true)
+    end
+    nothing
+end
+
+function Base.timedwait(sem::EventSemaphore, secs::Real)
+    deadline = time() + secs
+    while !trywait(sem)
+        remaining = deadline - time()
+        remaining > 0 || throw(TimeoutError())
+        FileWatching.poll_fd(RawFD(fd(sem)), remaining; readable = true)
+    end
+    nothing
+end
+
+# Yield the address of the value stored by a reference, the caller is
+# responsible for preserving the reference.
+_pointer(ref::Base.RefValue{T}) where {T} = Base.unsafe_convert(Ptr{T}, ref)
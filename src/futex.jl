@@ -0,0 +1,109 @@
+#
+# futex.jl --
+#
+# Waiting for and waking up on 32-bit words in shared memory for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+IPC.futex_wait(mem, off, expected; timeout=Inf) -> bool
+```
+
+blocks the calling thread while the 32-bit word at offset `off` (in bytes) in
+the memory object `mem` (e.g. a [`SharedMemory`](@ref) or a
+[`WrappedArray`](@ref)) has the value `expected` and until another thread or
+process calls [`IPC.futex_wake`](@ref) for the same word or until `timeout`
+seconds have elapsed.  The result is `false` if the time limit expired and
+`true` otherwise.
+
+The value of the word is compared to `expected` atomically with respect to
+calls to `IPC.futex_wake`, so no wake-up can be missed between the checking of
+the value by the caller and the call to `IPC.futex_wait`.  The call returns
+immediately if the value is not `expected`.  Spurious wake-ups (e.g. when a
+signal is received) are possible, so the caller must check again the value of
+the word and call `IPC.futex_wait` again if needed, typically:
+
+```julia
+while IPC.atomic_load(mem, UInt32, off, :acquire) == val
+    IPC.futex_wait(mem, off, val)
+end
+```
+
+The word must be aligned on a 4-byte boundary.  Futexes are shared between
+processes: any process mapping the same memory may wait for or wake up on the
+word, whatever the address at which the memory is mapped.  Futexes are only
+available on Linux, elsewhere a `SystemError` is thrown with code `ENOSYS`.
+
+See also: [`IPC.futex_wake`](@ref), [`IPC.atomic_load`](@ref).
+
+"""
+function futex_wait(mem, off::Integer, expected::Integer;
+                    timeout::Real = Inf)
+    ptr = _atomic_pointer(mem, UInt32, off)
+    return GC.@preserve mem _futex_wait(ptr, expected % UInt32, timeout)
+end
+
+"""
+```julia
+IPC.futex_wake(mem, off, n=1) -> nwoken
+```
+
+wakes up at most `n` of the threads or processes waiting in
+[`IPC.futex_wait`](@ref) on the 32-bit word at offset `off` (in bytes) in the
+memory object `mem` and yields the number of waiters that were woken up.  Use
+`n = typemax(Cint)` to wake up all waiters.  The caller shall modify the value
+of the word before calling `IPC.futex_wake`.  If no-one is waiting, the cost
+of the call is that of a system call, so it is common to keep track of
+whether there may be waiters in the word itself to avoid calling
+`IPC.futex_wake` in the uncontended case.
+
+See also: [`IPC.futex_wait`](@ref), [`IPC.atomic_store!`](@ref).
+
+"""
+function futex_wake(mem, off::Integer, n::Integer = 1)
+    n ≥ 0 || throw_argument_error("invalid number of waiters (", n, ")")
+    ptr = _atomic_pointer(mem, UInt32, off)
+    return GC.@preserve mem _futex_wake(ptr, n)
+end
+
+# Wait on the futex at address `ptr` while its value is `val`.  The caller is
+# responsible for preserving the memory.
+function _futex_wait(ptr::Ptr{UInt32}, val::UInt32, timeout::Real = Inf)
+    if isinf(timeout) && timeout > 0
+        res = _futex(ptr, FUTEX_WAIT, val, Ptr{TimeSpec}(C_NULL))
+    else
+        ts = Ref(TimeSpec(max(Float64(timeout), 0.0)))
+        res = _futex(ptr, FUTEX_WAIT, val, ts)
+    end
+    if res == -1
+        code = Libc.errno()
+        if code == Libc.ETIMEDOUT
+            return false
+        elseif code != Libc.EAGAIN && code != Libc.EINTR
+            throw_system_error("futex", code)
+        end
+    end
+    return true
+end
+
+# Wake up at most `n` waiters of the futex at address `ptr`.  The caller is
+# responsible for preserving the memory.
+function _futex_wake(ptr::Ptr{UInt32}, n::Integer)
+    res = _futex(ptr, FUTEX_WAKE, min(n, typemax(Cint)), Ptr{TimeSpec}(C_NULL))
+    res == -1 && throw_system_error("futex")
+    return Int(res)
+end
+
+@static if !isdefined(@__MODULE__, :SYS_futex)
+    # Only used as arguments to `_futex` which fails with `ENOSYS`.
+    const FUTEX_WAIT = Cint(0)
+    const FUTEX_WAKE = Cint(1)
+end
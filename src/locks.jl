@@ -93,7 +93,7 @@ Base.islocked(obj::Mutex) = obj.locked
 
 function Base.lock(obj::Mutex)
     islocked(obj) && error("mutex is already locked by owner")
-    code = ccall(:pthread_mutex_lock, Cint, (Ptr{MutexData},), obj)
+    code = @gcsafe ccall(:pthread_mutex_lock, Cint, (Ptr{MutexData},), obj)
     code == 0 || throw_system_error("pthread_mutex_lock", code)
     obj.locked = true
     nothing
@@ -200,8 +200,8 @@ function Base.broadcast(cond::Condition)
 end
 
 function Base.wait(cond::Condition, mutex::Mutex)
-    code = ccall(:pthread_cond_wait, Cint,
-                 (Ptr{ConditionData}, Ptr{MutexData}), cond, mutex)
+    code = @gcsafe ccall(:pthread_cond_wait, Cint,
+                         (Ptr{ConditionData}, Ptr{MutexData}), cond, mutex)
     code == 0 || throw_system_error("pthread_cond_wait", code)
     nothing
 end
@@ -224,9 +224,9 @@ the time limit, and `false` otherwise.
 
 """
 function Base.timedwait(cond::Condition, mutex::Mutex, abstime::TimeSpec)
-    code = ccall(:pthread_cond_timedwait, Cint,
-                 (Ptr{ConditionData}, Ptr{MutexData}, Ptr{TimeSpec}),
-                 cond, mutex, Ref(abstime))
+    code = @gcsafe ccall(:pthread_cond_timedwait, Cint,
+                         (Ptr{ConditionData}, Ptr{MutexData}, Ptr{TimeSpec}),
+                         cond, mutex, Ref(abstime))
     if code != 0
         code == Libc.ETIMEDOUT || throw_system_error("pthread_cond_timedwait", code)
         return false
@@ -327,10 +327,12 @@ function Base.lock(obj::RWLock, mode::Char)
               mode == 'w' ? 2 : throw(ArgumentError("invalid mode")))
     islocked(obj) && error("r/w lock is already locked by owner")
     if mode == 'r'
-        code = ccall(:pthread_rwlock_rdlock, Cint, (Ptr{RWLockData},), obj)
+        code = @gcsafe ccall(:pthread_rwlock_rdlock, Cint,
+                             (Ptr{RWLockData},), obj)
         code == 0 || throw_system_error("pthread_rwlock_rdlock", code)
     else
-        code = ccall(:pthread_rwlock_wrlock, Cint, (Ptr{RWLockData},), obj)
+        code = @gcsafe ccall(:pthread_rwlock_wrlock, Cint,
+                             (Ptr{RWLockData},), obj)
         code == 0 || throw_system_error("pthread_rwlock_wrlock", code)
     end
     obj.locked = locked
@@ -412,16 +414,18 @@ function timedlock(obj::RWLock, mode::Char, abstime::TimeSpec)
               mode == 'w' ? 2 : throw(ArgumentError("invalid mode")))
     if obj.locked == 0
         if mode == 'r'
-            code = ccall(:pthread_rwlock_timedrdlock, Cint,
-                         (Ptr{RWLockData}, Ref{TimeSpec}), obj, Ref(abstime))
+            code = @gcsafe ccall(:pthread_rwlock_timedrdlock, Cint,
+                                 (Ptr{RWLockData}, Ref{TimeSpec}),
+                                 obj, Ref(abstime))
             if code != 0
                 code == Libc.ETIMEDOUT ||
                     throw_system_error("pthread_rwlock_timedrdlock", code)
                 return false
             end
         else
-            code = ccall(:pthread_rwlock_timedwrlock, Cint,
-                         (Ptr{RWLockData}, Ref{TimeSpec}), obj, Ref(abstime))
+            code = @gcsafe ccall(:pthread_rwlock_timedwrlock, Cint,
+                                 (Ptr{RWLockData}, Ref{TimeSpec}),
+                                 obj, Ref(abstime))
             if code != 0
                 code == Libc.ETIMEDOUT ||
                     throw_system_error("pthread_rwlock_timedwrlock", code)
@@ -445,6 +449,167 @@ timedlock(obj::RWLock, mode::Char, abstime::Union{TimeVal,Libc.TimeVal}) =
 timedlock(obj::RWLock, mode::Char, secs::Real) =
     timedlock(obj, mode, now(TimeSpec) + secs)
 
+"""
+```julia
+IPC.AdaptiveMutex(buf, off=0; spins=1000, init=true)
+```
+
+yields a mutex object whose state is a 32-bit word stored in buffer `buf` at
+offset `off` (in bytes).  There must be at least 4 available bytes at address
+`pointer(buf) + off`, this address must be a multiple of 4 and these bytes
+must not be used for something else and must remain accessible during the
+lifetime of the object.  If `buf` is shared memory, the mutex is shared by all
+processes which create an `IPC.AdaptiveMutex` object for the same bytes.
+Keyword `init` specifies whether to initialize the mutex in an unlocked state,
+it must be set to `false` by processes attaching an existing mutex which may
+be in use.
+
+```julia
+IPC.AdaptiveMutex(; spins=1000)
+```
+
+yields a mutex private to the process.
+
+Contrarily to [`IPC.Mutex`](@ref), an adaptive mutex does not immediately
+block the thread if the mutex is locked: it first spins, pausing the processor
+for an exponentially increasing number of cycles between attempts (up to a
+total of `spins` pauses), and then sleeps in the kernel by means of a futex
+until the mutex is unlocked.  Locking and unlocking an uncontended adaptive
+mutex costs a single atomic operation and no system calls.  This is well
+suited to very short critical sections for which the cost of a context switch
+exceeds that of the protected work.  Sleeping in the kernel is only available
+on Linux, elsewhere the mutex is polled after spinning while yielding to other
+tasks.
+
+The object counts the number of times the mutex has been locked immediately,
+after spinning or after sleeping, these counters are given by
+`IPC.lockstats(mutex)`.
+
+See also: [`IPC.Mutex`](@ref), [`lock`](@ref), [`unlock`](@ref),
+[`trylock`](@ref), [`IPC.futex_wait`](@ref).
+
+"""
+mutable struct AdaptiveMutex{T}
+    handle::Ptr{UInt32} # address of the state of the mutex
+    buffer::T           # object storing the state
+    spins::Int          # maximum number of pauses before sleeping
+    locked::Bool
+    fast::Int           # number of times the mutex was immediately locked
+    spun::Int           # number of times the mutex was locked while spinning
+    parked::Int         # number of times the mutex was locked after sleeping
+    function AdaptiveMutex{T}(buf::T, off::Int; spins::Integer = 1000,
+                              init::Bool = true) where {T}
+        spins ≥ 0 || throw_argument_error("invalid number of spins (",
+                                          spins, ")")
+        ptr = _atomic_pointer(buf, UInt32, off)
+        init && _atomic_store!(ptr, _MUTEX_UNLOCKED, :release)
+        return new{T}(ptr, buf, spins, false, 0, 0, 0)
+    end
+end
+
+AdaptiveMutex(buf::T, off::Integer = 0; kwds...) where {T} =
+    AdaptiveMutex{T}(buf, Int(off); kwds...)
+
+AdaptiveMutex(; spins::Integer = 1000) =
+    AdaptiveMutex(zeros(UInt32, 1); spins = spins)
+
+# States of an adaptive mutex, see "Futexes Are Tricky" by Ulrich Drepper.
+const _MUTEX_UNLOCKED  = UInt32(0) # mutex is unlocked
+const _MUTEX_LOCKED    = UInt32(1) # mutex is locked, no waiters
+const _MUTEX_CONTENDED = UInt32(2) # mutex is locked, there may be waiters
+
+# Maximum number of pauses between two attempts of locking a mutex.
+const _MUTEX_MAX_DELAY = 64
+
+# Whether contended adaptive mutexes can sleep in the kernel.
+const _HAVE_FUTEXES = isdefined(@__MODULE__, :SYS_futex)
+
+Base.islocked(obj::AdaptiveMutex) = obj.locked
+
+function Base.lock(obj::AdaptiveMutex)
+    islocked(obj) && error("mutex is already locked by owner")
+    ptr = obj.handle
+    GC.@preserve obj begin
+        c, ok = _atomic_cas!(ptr, _MUTEX_UNLOCKED, _MUTEX_LOCKED, :acquire)
+        if ok
+            obj.fast += 1
+        elseif _adaptive_spin(ptr, obj.spins)
+            obj.spun += 1
+        else
+            # Mark the mutex as contended and sleep until it is unlocked.
+            # Without futexes, poll the mutex yielding to other tasks.
+            c = _atomic_xchg!(ptr, _MUTEX_CONTENDED, :acquire)
+            n = 0
+            while c != _MUTEX_UNLOCKED
+                if _HAVE_FUTEXES
+                    _futex_wait(ptr, _MUTEX_CONTENDED)
+                else
+                    n = _backoff(n)
+                end
+                c = _atomic_xchg!(ptr, _MUTEX_CONTENDED, :acquire)
+            end
+            obj.parked += 1
+        end
+    end
+    obj.locked = true
+    nothing
+end
+
+# Attempt to lock a mutex by spinning for at most `spins` pauses.
+function _adaptive_spin(ptr::Ptr{UInt32}, spins::Int)
+    delay = 1
+    while spins > 0
+        for i in 1:min(delay, spins)
+            _cpu_pause()
+        end
+        spins -= delay
+        delay = min(2*delay, _MUTEX_MAX_DELAY)
+        if _atomic_load(ptr, :monotonic) == _MUTEX_UNLOCKED
+            c, ok = _atomic_cas!(ptr, _MUTEX_UNLOCKED, _MUTEX_LOCKED, :acquire)
+            ok && return true
+        end
+    end
+    return false
+end
+
+function Base.unlock(obj::AdaptiveMutex)
+    islocked(obj) || error("mutex is not locked by owner")
+    ptr = obj.handle
+    GC.@preserve obj begin
+        if (_atomic_xchg!(ptr, _MUTEX_UNLOCKED, :release) == _MUTEX_CONTENDED &&
+            _HAVE_FUTEXES)
+            _futex_wake(ptr, 1)
+        end
+    end
+    obj.locked = false
+    nothing
+end
+
+function Base.trylock(obj::AdaptiveMutex)
+    if ! islocked(obj)
+        c, ok = GC.@preserve obj _atomic_cas!(obj.handle, _MUTEX_UNLOCKED,
+                                              _MUTEX_LOCKED, :acquire)
+        ok || return false
+        obj.fast += 1
+        obj.locked = true
+    end
+    return true
+end
+
+"""
+```julia
+IPC.lockstats(mutex) -> (fast, spun, parked)
+```
+
+yields the number of times the adaptive mutex `mutex` has been locked by its
+owner immediately, after spinning and after sleeping in the kernel.
+
+See also: [`IPC.AdaptiveMutex`](@ref).
+
+"""
+lockstats(obj::AdaptiveMutex) =
+    (fast = obj.fast, spun = obj.spun, parked = obj.parked)
+
 # The following are needed for ccall's.
 Base.unsafe_convert(::Type{Ptr{MutexData}}, obj::Mutex) = obj.handle
 Base.unsafe_convert(::Type{Ptr{ConditionData}}, obj::Condition) = obj.handle
@@ -0,0 +1,203 @@
+#
+# numa.jl --
+#
+# Placement of memory on NUMA nodes for the InterProcessCommunication (IPC)
+# package of Julia.  The Linux system calls are directly used so that libnuma
+# is not needed.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+IPC.mempolicy!(obj, policy; move=false) -> obj
+```
+
+sets the NUMA placement policy of the memory backing object `obj` which can be
+a [`SharedMemory`](@ref) object, a [`WrappedArray`](@ref) or any object
+implementing `pointer(obj)` and `sizeof(obj)`.  The policy applies to all the
+memory pages overlapping the memory of `obj`.  Argument `policy` can be:
+
+* `:default` or `:firsttouch` to have pages allocated on the node of the CPU
+  which first touches them (the system default);
+
+* `:interleave` to have pages interleaved on all online nodes;
+
+* an integer `node` to bind pages to a given node;
+
+* `(:bind, nodes)`, `(:interleave, nodes)` or `(:preferred, node)` to bind
+  pages to a given set of nodes, to interleave pages on a given set of nodes,
+  or to allocate pages preferably on a given node.
+
+Nodes are numbered from `0` and must be online (see [`IPC.numanodes`](@ref)).
+The policy only applies to pages faulted-in later, unless keyword `move` is
+true to attempt to migrate existing pages (only those exclusively used by the
+calling process can be moved).  For shared memory, the policy is attached to
+the shared memory object, so it also applies to pages faulted-in by other
+processes.
+
+The NUMA placement policy of shared memory can also be specified when creating
+or attaching shared memory with keyword `numa` (see [`SharedMemory`](@ref)).
+
+On machines with a single NUMA node, the policy is checked but otherwise
+ignored.
+
+See also: [`IPC.numanodes`](@ref), [`IPC.pagenodes`](@ref).
+
+"""
+function mempolicy!(obj, policy; move::Bool = false)
+    pol = MemPolicy(policy)
+    ptr, len = get_memory_parameters(obj)
+    _set_mempolicy(ptr, len, pol, move) == SUCCESS ||
+        throw_system_error("mbind")
+    return obj
+end
+
+"""
+```julia
+IPC.numanodes() -> nodes
+```
+
+yields the list of online NUMA nodes.  On systems without NUMA support, `[0]`
+is returned.
+
+See also: [`IPC.mempolicy!`](@ref), [`IPC.pagenodes`](@ref).
+
+"""
+function numanodes()
+    nodes = Int[]
+    path = "/sys/devices/system/node/online"
+    if isfile(path)
+        # Format is a comma separated list of nodes or ranges of nodes (e.g.
+        # "0-1,3").
+        for rng in split(strip(read(path, String)), ','; keepempty=false)
+            bnds = split(rng, '-')
+            append!(nodes, parse(Int, bnds[1]):parse(Int, bnds[end]))
+        end
+    end
+    isempty(nodes) && push!(nodes, 0)
+    return nodes
+end
+
+"""
+```julia
+IPC.pagenodes(obj) -> nodes
+```
+
+yields a vector of integers indicating the NUMA node where lives each memory
+page backing object `obj` (see [`IPC.mempolicy!`](@ref) for possible kinds of
+objects).  A value of `-1` indicates a page that has not yet been faulted-in.
+
+On machines with a single NUMA node, the system may forbid or not implement
+this query, in which case all pages are reported as living on the only node.
+
+See also: [`IPC.mempolicy!`](@ref), [`IPC.numanodes`](@ref).
+
+"""
+function pagenodes(obj)
+    ptr, len = get_memory_parameters(obj)
+    off, cnt = _page_range(ptr, len)
+    pages = Ptr{Cvoid}[ptr - off + (i - 1)*PAGE_SIZE for i in 1:cnt]
+    status = fill(Cint(-1), cnt)
+    code = GC.@preserve pages status _move_pages(0, cnt, pointer(pages),
+                                                 Ptr{Cint}(0),
+                                                 pointer(status), 0)
+    if code == -1
+        errno = Libc.errno()
+        online = numanodes()
+        if length(online) == 1 && (errno == Libc.ENOSYS ||
+                                   errno == Libc.EPERM)
+            return fill(online[1], cnt)
+        end
+        throw_system_error("move_pages", errno)
+    end
+    return Int[(s ≥ 0 ? Int(s) : -1) for s in status]
+end
+
+# Structure to store a validated NUMA memory policy.
+struct MemPolicy
+    mode::Cint
+    nodes::Vector{Int}
+end
+
+MemPolicy(pol::MemPolicy) = pol
+
+MemPolicy(node::Integer) = MemPolicy((:bind, node))
+
+function MemPolicy(policy::Symbol)
+    if policy == :default || policy == :firsttouch
+        return MemPolicy(_mpol(:default), Int[])
+    elseif policy == :interleave
+        return MemPolicy(_mpol(:interleave), numanodes())
+    end
+    throw_argument_error("unknown NUMA policy `:", policy, "`")
+end
+
+function MemPolicy(policy::Tuple{Symbol,Any})
+    kind, nodes = policy
+    if kind ∈ (:bind, :interleave, :preferred) &&
+        (isa(nodes, Integer) || isa(nodes, AbstractVector{<:Integer}))
+        list = (isa(nodes, Integer) ? [Int(nodes)] : Int[n for n in nodes])
+        isempty(list) && throw_argument_error("empty list of NUMA nodes")
+        kind == :preferred && length(list) != 1 &&
+            throw_argument_error("a single NUMA node must be preferred")
+        online = numanodes()
+        for node in list
+            node ∈ online ||
+                throw_argument_error("NUMA node ", node, " is not online")
+        end
+        return MemPolicy(_mpol(kind), list)
+    end
+    throw_argument_error("invalid NUMA policy ", repr(policy))
+end
+
+MemPolicy(policy) = throw_argument_error("invalid NUMA policy ", repr(policy))
+
+@static if isdefined(@__MODULE__, :MPOL_DEFAULT)
+    _mpol(kind::Symbol) = (kind == :default    ? MPOL_DEFAULT    :
+                           kind == :bind       ? MPOL_BIND       :
+                           kind == :interleave ? MPOL_INTERLEAVE :
+                           kind == :preferred  ? MPOL_PREFERRED  :
+                           throw_argument_error("unknown NUMA policy `:",
+                                                kind, "`"))
+    const _MPOL_MF_MOVE = MPOL_MF_MOVE
+else
+    _mpol(kind::Symbol) = Cint(-1)
+    const _MPOL_MF_MOVE = Cuint(0)
+end
+
+# Yield the offset of address `ptr` relative to the start of its memory page
+# and the number of memory pages overlapping `len` bytes at `ptr`.
+function _page_range(ptr::Ptr, len::Integer)
+    addr = convert(Int, ptr)
+    step = Int(PAGE_SIZE)
+    off = mod(addr, step)
+    return off, div(off + Int(len) + step - 1, step)
+end
+
+# Apply NUMA policy `pol` to `len` bytes of memory at address `ptr`.  Returns
+# `SUCCESS` or `FAILURE` (with `errno` set).  On machines with a single NUMA
+# node, the system is not called at all.
+function _set_mempolicy(ptr::Ptr, len::Integer, pol::MemPolicy, move::Bool)
+    length(numanodes()) ≤ 1 && return SUCCESS
+    off, cnt = _page_range(ptr, len)
+    nbits = 8*sizeof(Culong)
+    mask = zeros(Culong, (isempty(pol.nodes) ? 0 :
+                          div(maximum(pol.nodes) + nbits, nbits)))
+    for node in pol.nodes
+        i, j = divrem(node, nbits)
+        mask[i+1] |= one(Culong) << j
+    end
+    # The kernel only considers the `maxnode - 1` first bits of the mask.
+    maxnode = (isempty(mask) ? 0 : nbits*length(mask) + 1)
+    flags = (move ? _MPOL_MF_MOVE : zero(Cuint))
+    status = GC.@preserve mask _mbind(ptr - off, cnt*PAGE_SIZE, pol.mode,
+                                      pointer(mask), maxnode, flags)
+    return (status == 0 ? SUCCESS : FAILURE)
+end
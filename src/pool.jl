@@ -0,0 +1,205 @@
+#
+# pool.jl --
+#
+# Lock-free pools of fixed-size slots in shared memory for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmPool(mem, slotsize, nslots; offset=0) -> pool
+```
+
+creates a new pool of `nslots` slots of `slotsize` bytes each stored by memory
+object `mem` at relative position (in bytes) specified by keyword `offset`.
+The memory object is typically a [`SharedMemory`](@ref) so that the pool can be
+used by several processes.  The number of bytes needed by the pool is given by
+`sizeof(ShmPool, slotsize, nslots)`.
+
+```julia
+ShmPool(mem; offset=0) -> pool
+```
+
+yields an instance of `ShmPool` associated with an existing pool stored by
+memory object `mem` at relative position given by keyword `offset`.  This is
+how other processes attach the pool.
+
+The pool may also be directly stored in new shared memory identified by `id`
+(see [`SharedMemory`](@ref) for a description of `id` and for keywords `kwds`)
+and retrieved by other processes with:
+
+```julia
+ShmPool(id, slotsize, nslots; kwds...) -> pool # create
+ShmPool(id; kwds...) -> pool                   # attach
+```
+
+Slots are acquired and released by:
+
+```julia
+i = IPC.acquire!(pool)
+IPC.release!(pool, i)
+```
+
+where `i` is the index of the slot (in the range `1:length(pool)`) or 0 if no
+slots are available.  Indices are the same for all processes and can thus be
+sent to other processes (e.g. through a queue) to hand over slots.  `pool[i]`
+yields a [`WrappedArray`](@ref) vector of bytes to access the contents of the
+`i`-th slot and `pointer(pool, i)` yields its address.  Releasing a slot which
+is not acquired throws an `ArgumentError`.
+
+Slots are aligned on 64 bytes (the size of a cache line) and the free slots
+are managed by a lock-free stack with a tagged head to avoid the ABA problem.
+Acquiring or releasing a slot thus only costs a few atomic operations and no
+system calls, it may be done concurrently by any threads of any processes.
+
+"""
+function ShmPool(mem::M, slotsize::Integer, nslots::Integer;
+                 offset::Integer = 0) where {M}
+    slotsize ≥ 1 || throw_argument_error("invalid slot size (", slotsize, ")")
+    1 ≤ nslots < _POOL_ACQUIRED ||
+        throw_argument_error("invalid number of slots (", nslots, ")")
+    stride, data = _pool_layout(slotsize, nslots)
+    base = _shared_address(mem, offset, data + stride*nslots, _POOL_ALIGN)
+    _poke!(UInt64, base + 8, slotsize)
+    _poke!(UInt64, base + 16, nslots)
+    nxt = Ptr{UInt32}(base + _POOL_NEXT_OFFSET)
+    for i in 1:nslots
+        _poke!(UInt32, nxt + 4*(i - 1), (i < nslots ? i + 1 : 0))
+    end
+    _atomic_store!(Ptr{UInt64}(base + _POOL_HEAD_OFFSET), 1, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _POOL_MAGIC, :release)
+    return ShmPool{M}(mem, offset, slotsize, nslots, stride, data)
+end
+
+function ShmPool(mem::M; offset::Integer = 0) where {M}
+    base = _shared_address(mem, offset, _POOL_NEXT_OFFSET, _POOL_ALIGN)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _POOL_MAGIC ||
+        throw_argument_error("no pool at given offset")
+    slotsize = Int(_peek(UInt64, base + 8))
+    nslots = Int(_peek(UInt64, base + 16))
+    stride, data = _pool_layout(slotsize, nslots)
+    _shared_address(mem, offset, data + stride*nslots, _POOL_ALIGN)
+    return ShmPool{M}(mem, offset, slotsize, nslots, stride, data)
+end
+
+function ShmPool(id::Union{AbstractString,ShmId,Key,File,Type{FileDescriptor}},
+                 slotsize::Integer, nslots::Integer; kwds...)
+    mem = SharedMemory(id, sizeof(ShmPool, slotsize, nslots); kwds...)
+    return ShmPool(mem, slotsize, nslots)
+end
+
+ShmPool(id::Union{AbstractString,ShmId,Key,File,FileDescriptor}; kwds...) =
+    ShmPool(SharedMemory(id; kwds...))
+
+Base.sizeof(::Type{<:ShmPool}, slotsize::Integer, nslots::Integer) =
+    sum(_pool_layout(slotsize, nslots) .* (nslots, 1))
+
+Base.length(pool::ShmPool) = pool.nslots
+Base.pointer(pool::ShmPool) = pointer(pool.mem) + pool.off
+Base.pointer(pool::ShmPool, i::Integer) =
+    pointer(pool) + pool.data + pool.stride*(_check_slot(pool, i) - 1)
+
+Base.getindex(pool::ShmPool, i::Integer) =
+    WrappedArray(pool.mem, UInt8, pool.slotsize;
+                 offset = pool.off + pool.data +
+                 pool.stride*(_check_slot(pool, i) - 1))
+
+"""
+```julia
+IPC.slotsize(obj) -> n
+```
+
+yields the size (in bytes) of the slots of `obj`, a pool or a broadcast ring
+in shared memory.
+
+"""
+slotsize(pool::ShmPool) = pool.slotsize
+
+"""
+```julia
+IPC.acquire!(pool) -> i
+```
+
+acquires a free slot of `pool` and yields its index or 0 if all slots are in
+use.
+
+```julia
+IPC.release!(pool, i)
+```
+
+releases the `i`-th slot of `pool`.
+
+See [`ShmPool`](@ref) for details.
+
+"""
+function acquire!(pool::ShmPool)
+    base = pointer(pool)
+    head = Ptr{UInt64}(base + _POOL_HEAD_OFFSET)
+    nxt = Ptr{UInt32}(base + _POOL_NEXT_OFFSET)
+    while true
+        h = _atomic_load(head, :acquire)
+        i = Int(h & 0xffffffff)
+        i == 0 && return 0
+        # The link may be garbage if the slot has been acquired by someone
+        # else meanwhile, but then the tag has changed and the CAS fails.
+        link = _atomic_load(nxt + 4*(i - 1), :monotonic)
+        if _atomic_cas!(head, h, _pool_tag(h, link))[2]
+            _atomic_store!(nxt + 4*(i - 1), _POOL_ACQUIRED, :monotonic)
+            return i
+        end
+        _cpu_pause()
+    end
+end
+
+function release!(pool::ShmPool, i::Integer)
+    _check_slot(pool, i)
+    base = pointer(pool)
+    head = Ptr{UInt64}(base + _POOL_HEAD_OFFSET)
+    ptr = Ptr{UInt32}(base + _POOL_NEXT_OFFSET) + 4*(i - 1)
+    _atomic_cas!(ptr, _POOL_ACQUIRED, 0)[2] ||
+        throw_argument_error("slot ", i, " is not acquired")
+    h = _atomic_load(head, :monotonic)
+    while true
+        _atomic_store!(ptr, h & 0xffffffff, :monotonic)
+        h, ok = _atomic_cas!(head, h, _pool_tag(h, i), :release)
+        ok && break
+    end
+    nothing
+end
+
+@doc @doc(acquire!) release!
+
+# Layout of a pool.  The header stores the magic number, the size of the slots
+# and their number and, on the next cache line, the head of the list of free
+# slots.  The head stores the index of the first free slot (0 if none) in its
+# 32 least significant bits and a tag incremented by every change in its 32
+# most significant bits.  The header is followed by the links of the list (the
+# index of the next free slot or `_POOL_ACQUIRED` for acquired slots) and by
+# the slots.
+const _POOL_MAGIC = 0x4c4f4f5043435049 # "IPCCPOOL" in little endian order
+const _POOL_ALIGN = 64
+const _POOL_HEAD_OFFSET = 64
+const _POOL_NEXT_OFFSET = 128
+const _POOL_ACQUIRED = typemax(UInt32)
+
+# Yield the distance between successive slots and the offset of the first
+# slot relative to the base of the pool.
+_pool_layout(slotsize::Integer, nslots::Integer) =
+    (roundup(Int(slotsize), _POOL_ALIGN),
+     roundup(_POOL_NEXT_OFFSET + 4*Int(nslots), _POOL_ALIGN))
+
+@inline _pool_tag(h::UInt64, i::Integer) =
+    (((h >> 32) + 1) << 32) | (UInt64(i) & 0xffffffff)
+
+@inline function _check_slot(pool::ShmPool, i::Integer)
+    1 ≤ i ≤ pool.nslots ||
+        throw_argument_error("out of range slot index (", i, ")")
+    return Int(i)
+end
@@ -0,0 +1,216 @@
+#
+# queue.jl --
+#
+# Lock-free bounded multi-producer/multi-consumer queues in shared memory for
+# Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmQueue{T}(mem, cap; offset=0) -> queue
+```
+
+creates a new bounded first-in first-out queue of capacity `cap` values of
+type `T` stored by memory object `mem` at relative position (in bytes)
+specified by keyword `offset`.  The memory object is typically a
+[`SharedMemory`](@ref) so that the queue can be used by several processes.
+The capacity must be a power of 2 and the element type a bits type.  The
+number of bytes needed by the queue is given by `sizeof(ShmQueue{T}, cap)`.
+
+```julia
+ShmQueue{T}(mem; offset=0) -> queue
+```
+
+yields an instance of `ShmQueue` associated with an existing queue stored by
+memory object `mem` at relative position given by keyword `offset`.  This is
+how other processes attach the queue.
+
+The queue may also be directly stored in new shared memory identified by `id`
+(see [`SharedMemory`](@ref) for a description of `id` and for keywords `kwds`)
+and retrieved by other processes with:
+
+```julia
+ShmQueue{T}(id, cap; kwds...) -> queue # create
+ShmQueue{T}(id; kwds...) -> queue      # attach
+```
+
+Contrarily to [`ShmRing`](@ref), any number of producers and consumers, in any
+threads of any processes, may concurrently push and pop values with:
+
+```julia
+IPC.trypush!(queue, x) -> bool     # never blocks
+IPC.trypop!(queue) -> x_or_nothing # never blocks
+push!(queue, x)                    # blocks while the queue is full
+pop!(queue) -> x                   # blocks while the queue is empty
+```
+
+`IPC.trypush!` yields whether value `x` has been pushed and `IPC.trypop!`
+yields `nothing` if the queue is empty.  Blocking methods spin, then yield to
+other tasks, until they can proceed.  `length(queue)` yields the approximate
+number of values in the queue, `isempty(queue)` and `IPC.isfull(queue)`
+whether it is empty or full and `IPC.capacity(queue)` its capacity.
+
+The queue implements the algorithm of Dmitry Vyukov: each slot has a sequence
+number telling whether it is ready to be written or read for a given turn and
+producers (resp. consumers) claim slots by a compare-and-swap on a shared
+index.  The two indices live on separate cache lines.  Pushing or popping a
+value thus costs a single compare-and-swap in the absence of contention and
+does not call the system.  A producer (resp. consumer) suspended between
+claiming a slot and publishing its value (resp. releasing the slot) delays
+consumers (resp. producers) of that slot only.
+
+"""
+function ShmQueue{T}(mem::M, cap::Integer; offset::Integer = 0) where {T,M}
+    _check_ring_eltype(T)
+    cap ≥ 2 && ispow2(cap) ||
+        throw_argument_error("capacity must be a power of 2 (", cap, ")")
+    base = _shared_address(mem, offset, sizeof(ShmQueue{T}, cap))
+    _poke!(UInt64, base + 8, sizeof(T))
+    _poke!(UInt64, base + 16, cap)
+    stride = _queue_stride(T)
+    for i in 0:cap-1
+        _atomic_store!(Ptr{UInt64}(base + _QUEUE_CELLS_OFFSET + stride*i), i,
+                       :monotonic)
+    end
+    _atomic_store!(Ptr{UInt64}(base + _QUEUE_ENQ_OFFSET), 0, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base + _QUEUE_DEQ_OFFSET), 0, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _QUEUE_MAGIC, :release)
+    return ShmQueue{T,M}(mem, offset, cap)
+end
+
+function ShmQueue{T}(mem::M; offset::Integer = 0) where {T,M}
+    _check_ring_eltype(T)
+    base = _shared_address(mem, offset, _QUEUE_CELLS_OFFSET)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _QUEUE_MAGIC ||
+        throw_argument_error("no queue at given offset")
+    _peek(UInt64, base + 8) == sizeof(T) ||
+        throw_argument_error("size of elements does not match")
+    cap = Int(_peek(UInt64, base + 16))
+    _shared_address(mem, offset, sizeof(ShmQueue{T}, cap))
+    return ShmQueue{T,M}(mem, offset, cap)
+end
+
+function ShmQueue{T}(id::Union{AbstractString,ShmId,Key,File,
+                               Type{FileDescriptor}},
+                     cap::Integer; kwds...) where {T}
+    mem = SharedMemory(id, sizeof(ShmQueue{T}, cap); kwds...)
+    return ShmQueue{T}(mem, cap)
+end
+
+ShmQueue{T}(id::Union{AbstractString,ShmId,Key,File,FileDescriptor};
+            kwds...) where {T} = ShmQueue{T}(SharedMemory(id; kwds...))
+
+Base.sizeof(::Type{<:ShmQueue{T}}, cap::Integer) where {T} =
+    _QUEUE_CELLS_OFFSET + _queue_stride(T)*Int(cap)
+
+Base.eltype(::Type{<:ShmQueue{T}}) where {T} = T
+Base.pointer(queue::ShmQueue) = pointer(queue.mem) + queue.off
+function Base.length(queue::ShmQueue)
+    base = pointer(queue)
+    deq = _atomic_load(Ptr{UInt64}(base + _QUEUE_DEQ_OFFSET), :acquire)
+    enq = _atomic_load(Ptr{UInt64}(base + _QUEUE_ENQ_OFFSET), :acquire)
+    return clamp(reinterpret(Int64, enq - deq), 0, queue.cap)
+end
+Base.isempty(queue::ShmQueue) = length(queue) ≤ 0
+capacity(queue::ShmQueue) = queue.cap
+isfull(queue::ShmQueue) = length(queue) ≥ queue.cap
+
+function trypush!(queue::ShmQueue{T}, x) where {T}
+    val = convert(T, x)
+    base = pointer(queue)
+    enq = Ptr{UInt64}(base + _QUEUE_ENQ_OFFSET)
+    pos = _atomic_load(enq, :monotonic)
+    while true
+        cell = _queue_cell(queue, base, pos)
+        dif = reinterpret(Int64, _atomic_load(cell, :acquire) - pos)
+        if dif == 0
+            # The cell is ready to be written for this turn, attempt to claim
+            # it.
+            pos, ok = _atomic_cas!(enq, pos, pos + 1, :monotonic)
+            if ok
+                unsafe_store!(Ptr{T}(cell + _queue_offset(T)), val)
+                _atomic_store!(cell, pos + 1, :release)
+                return true
+            end
+        elseif dif < 0
+            # The cell has not yet been read for the previous turn.
+            return false
+        else
+            # Another producer has claimed the cell.
+            pos = _atomic_load(enq, :monotonic)
+        end
+    end
+end
+
+function trypop!(queue::ShmQueue{T}) where {T}
+    base = pointer(queue)
+    deq = Ptr{UInt64}(base + _QUEUE_DEQ_OFFSET)
+    pos = _atomic_load(deq, :monotonic)
+    while true
+        cell = _queue_cell(queue, base, pos)
+        dif = reinterpret(Int64, _atomic_load(cell, :acquire) - (pos + 1))
+        if dif == 0
+            # The cell has been written for this turn, attempt to claim it.
+            pos, ok = _atomic_cas!(deq, pos, pos + 1, :monotonic)
+            if ok
+                val = unsafe_load(Ptr{T}(cell + _queue_offset(T)))
+                _atomic_store!(cell, pos + queue.cap, :release)
+                return val
+            end
+        elseif dif < 0
+            # The cell has not yet been written for this turn.
+            return nothing
+        else
+            # Another consumer has claimed the cell.
+            pos = _atomic_load(deq, :monotonic)
+        end
+    end
+end
+
+function Base.push!(queue::ShmQueue, x)
+    spins = 0
+    while !trypush!(queue, x)
+        spins = _backoff(spins)
+    end
+    return queue
+end
+
+function Base.pop!(queue::ShmQueue)
+    spins = 0
+    while true
+        val = trypop!(queue)
+        val === nothing || return val
+        spins = _backoff(spins)
+    end
+end
+
+# Layout of a queue.  The header stores the magic number, the size of the
+# elements and the capacity of the queue and, each on its own cache line, the
+# index of the next value to push (claimed by producers) and of the next value
+# to pop (claimed by consumers).  The header is followed by the cells, each
+# cell stores a sequence number and a value.  The sequence number of the cell
+# for index `i` is `i` when the cell is ready to be written, `i + 1` when it is
+# ready to be read and `i + cap` when it is ready to be written for the next
+# turn.
+const _QUEUE_MAGIC = 0x554555512d435049 # "IPC-QUEU" in little endian order
+const _QUEUE_ENQ_OFFSET = 64
+const _QUEUE_DEQ_OFFSET = 128
+const _QUEUE_CELLS_OFFSET = 192
+
+# Yield the offset of the value in a cell and the size of a cell.
+_queue_offset(::Type{T}) where {T} = max(8, Base.datatype_alignment(T))
+_queue_stride(::Type{T}) where {T} =
+    roundup(_queue_offset(T) + sizeof(T), _queue_offset(T))
+
+# Yield the address of the sequence number of the cell for index `i`.
+@inline _queue_cell(queue::ShmQueue{T}, base::Ptr, i::UInt64) where {T} =
+    Ptr{UInt64}(base + _QUEUE_CELLS_OFFSET +
+                _queue_stride(T)*Int(i & UInt64(queue.cap - 1)))
@@ -0,0 +1,336 @@
+#
+# ring.jl --
+#
+# Lock-free single-producer/single-consumer ring buffers in shared memory for
+# Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmRing{T}(mem, cap; offset=0) -> ring
+```
+
+creates a new ring buffer, that is a first-in first-out queue, of capacity
+`cap` values of type `T` stored by memory object `mem` at relative position
+(in bytes) specified by keyword `offset`.  The memory object is typically a
+[`SharedMemory`](@ref) so that the ring can be used by two processes.  The
+capacity must be a power of 2 and the element type a bits type.  The number of
+bytes needed by the ring is given by `sizeof(ShmRing{T}, cap)`.
+
+```julia
+ShmRing{T}(mem; offset=0) -> ring
+```
+
+yields an instance of `ShmRing` associated with an existing ring stored by
+memory object `mem` at relative position given by keyword `offset`.  This is
+how the other process attaches the ring.
+
+The ring may also be directly stored in new shared memory identified by `id`
+(see [`SharedMemory`](@ref) for a description of `id` and for keywords `kwds`)
+and retrieved by the other process with:
+
+```julia
+ShmRing{T}(id, cap; kwds...) -> ring # create
+ShmRing{T}(id; kwds...) -> ring      # attach
+```
+
+The ring is meant to be used by a single producer and a single consumer
+(which may live in different processes).  The producer pushes values with:
+
+```julia
+IPC.trypush!(ring, x) -> bool # never blocks
+IPC.trypush!(ring, xs) -> n   # never blocks
+push!(ring, x)                # blocks while the ring is full
+append!(ring, xs)             # blocks until all values are pushed
+```
+
+where `x` is a single value and `xs` a vector of values.  `IPC.trypush!`
+yields whether value `x` has been pushed or the number `n` of leading values
+of `xs` which have been pushed (as many as there is room for).  The consumer
+pops values with:
+
+```julia
+IPC.trypop!(ring) -> x_or_nothing # never blocks
+IPC.trypop!(ring, buf) -> n       # never blocks
+pop!(ring) -> x                   # blocks while the ring is empty
+read!(ring, buf) -> buf           # blocks until `buf` is filled
+```
+
+where `buf` is a vector to store the popped values.  `IPC.trypop!(ring)`
+yields `nothing` if the ring is empty, while `IPC.trypop!(ring, buf)` yields
+the number `n` of values stored in the leading elements of `buf` (as many as
+available).  Blocking methods spin, then yield to other tasks, until they can
+proceed.
+
+`length(ring)` yields the number of values in the ring, `isempty(ring)` and
+`IPC.isfull(ring)` whether it is empty or full and `IPC.capacity(ring)` its
+capacity.
+
+The indices of the producer and of the consumer live on separate cache lines
+and each side keeps a local copy of the index of the other side which is only
+refreshed when the ring looks full or empty.  Pushing and popping values is
+thus wait-free, does not allocate and does not call the system.  Batched
+methods only publish their indices once for all values.
+
+"""
+function ShmRing{T}(mem::M, cap::Integer; offset::Integer = 0) where {T,M}
+    _check_ring_eltype(T)
+    cap ≥ 1 && ispow2(cap) ||
+        throw_argument_error("capacity must be a power of 2 (", cap, ")")
+    base = _shared_address(mem, offset, sizeof(ShmRing{T}, cap))
+    _poke!(UInt64, base + 8, sizeof(T))
+    _poke!(UInt64, base + 16, cap)
+    _atomic_store!(Ptr{UInt64}(base + _RING_HEAD_OFFSET), 0, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base + _RING_TAIL_OFFSET), 0, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _RING_MAGIC, :release)
+    return ShmRing{T,M}(mem, offset, cap, 0, 0)
+end
+
+function ShmRing{T}(mem::M; offset::Integer = 0) where {T,M}
+    _check_ring_eltype(T)
+    base = _shared_address(mem, offset, _RING_DATA_OFFSET)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _RING_MAGIC ||
+        throw_argument_error("no ring at given offset")
+    _peek(UInt64, base + 8) == sizeof(T) ||
+        throw_argument_error("size of elements does not match")
+    cap = Int(_peek(UInt64, base + 16))
+    _shared_address(mem, offset, sizeof(ShmRing{T}, cap))
+    head = _atomic_load(Ptr{UInt64}(base + _RING_HEAD_OFFSET), :acquire)
+    tail = _atomic_load(Ptr{UInt64}(base + _RING_TAIL_OFFSET), :acquire)
+    return ShmRing{T,M}(mem, offset, cap, head, tail)
+end
+
+function ShmRing{T}(id::Union{AbstractString,ShmId,Key,File,
+                              Type{FileDescriptor}},
+                    cap::Integer; kwds...) where {T}
+    mem = SharedMemory(id, sizeof(ShmRing{T}, cap); kwds...)
+    return ShmRing{T}(mem, cap)
+end
+
+ShmRing{T}(id::Union{AbstractString,ShmId,Key,File,FileDescriptor};
+           kwds...) where {T} = ShmRing{T}(SharedMemory(id; kwds...))
+
+Base.sizeof(::Type{<:ShmRing{T}}, cap::Integer) where {T} =
+    _RING_DATA_OFFSET + sizeof(T)*Int(cap)
+
+Base.eltype(::Type{<:ShmRing{T}}) where {T} = T
+Base.pointer(ring::ShmRing) = pointer(ring.mem) + ring.off
+function Base.length(ring::ShmRing)
+    # Load the head before the tail since the head never moves beyond the
+    # tail.  The result is clamped as both may move between the two loads.
+    base = pointer(ring)
+    head = _atomic_load(_ring_head(base), :acquire)
+    tail = _atomic_load(_ring_tail(base), :acquire)
+    return clamp(reinterpret(Int64, tail - head), 0, ring.cap)
+end
+Base.isempty(ring::ShmRing) = length(ring) ≤ 0
+
+"""
+```julia
+IPC.capacity(obj) -> cap
+```
+
+yields the maximum number of values that can be stored by `obj`, a ring
+buffer or a queue in shared memory.
+
+"""
+capacity(ring::ShmRing) = ring.cap
+
+"""
+```julia
+IPC.isfull(obj) -> bool
+```
+
+yields whether `obj`, a ring buffer or a queue in shared memory, is full.
+
+"""
+isfull(ring::ShmRing) = length(ring) ≥ ring.cap
+
+"""
+```julia
+IPC.trypush!(obj, x) -> bool
+```
+
+attempts to push value `x` in `obj`, a ring buffer or a queue in shared
+memory, without blocking.  Yields whether the value has been pushed.
+
+```julia
+IPC.trypush!(obj, xs) -> n
+```
+
+attempts to push the values of vector `xs` in `obj` without blocking.  Yields
+the number `n` of leading values of `xs` which have been pushed.
+
+See also: [`IPC.trypop!`](@ref).
+
+"""
+function trypush!(ring::ShmRing{T}, x) where {T}
+    val = convert(T, x)
+    base = pointer(ring)
+    tail = _ring_tail(base)
+    t = _atomic_load(tail, :monotonic) # only written by the producer
+    if t - ring.head ≥ ring.cap
+        ring.head = _atomic_load(_ring_head(base), :acquire)
+        t - ring.head ≥ ring.cap && return false
+    end
+    unsafe_store!(_ring_data(ring, base), val, _ring_index(ring, t))
+    _atomic_store!(tail, t + 1, :release)
+    return true
+end
+
+function trypush!(ring::ShmRing{T}, xs::AbstractVector{<:T}) where {T}
+    base = pointer(ring)
+    tail = _ring_tail(base)
+    t = _atomic_load(tail, :monotonic) # only written by the producer
+    n = length(xs)
+    if t - ring.head + n > ring.cap
+        ring.head = _atomic_load(_ring_head(base), :acquire)
+        n = min(n, ring.cap - Int(t - ring.head))
+    end
+    n ≤ 0 && return 0
+    data = _ring_data(ring, base)
+    i0 = firstindex(xs) - 1
+    @inbounds for i in 1:n
+        unsafe_store!(data, convert(T, xs[i0 + i]),
+                      _ring_index(ring, t + (i - 1)))
+    end
+    _atomic_store!(tail, t + n, :release)
+    return n
+end
+
+"""
+```julia
+IPC.trypop!(obj) -> x_or_nothing
+```
+
+attempts to pop a value from `obj`, a ring buffer or a queue in shared
+memory, without blocking.  Yields the value or `nothing` if `obj` is empty.
+
+```julia
+IPC.trypop!(obj, buf) -> n
+```
+
+attempts to pop as many values as possible from `obj` into vector `buf`
+without blocking.  Yields the number `n` of values stored in the leading
+elements of `buf`.
+
+See also: [`IPC.trypush!`](@ref).
+
+"""
+function trypop!(ring::ShmRing{T}) where {T}
+    base = pointer(ring)
+    head = _ring_head(base)
+    h = _atomic_load(head, :monotonic) # only written by the consumer
+    if h == ring.tail
+        ring.tail = _atomic_load(_ring_tail(base), :acquire)
+        h == ring.tail && return nothing
+    end
+    val = unsafe_load(_ring_data(ring, base), _ring_index(ring, h))
+    _atomic_store!(head, h + 1, :release)
+    return val
+end
+
+function trypop!(ring::ShmRing{T}, buf::AbstractVector{T}) where {T}
+    base = pointer(ring)
+    head = _ring_head(base)
+    h = _atomic_load(head, :monotonic) # only written by the consumer
+    n = length(buf)
+    if ring.tail - h < n
+        ring.tail = _atomic_load(_ring_tail(base), :acquire)
+        n = min(n, Int(ring.tail - h))
+    end
+    n ≤ 0 && return 0
+    data = _ring_data(ring, base)
+    i0 = firstindex(buf) - 1
+    @inbounds for i in 1:n
+        buf[i0 + i] = unsafe_load(data, _ring_index(ring, h + (i - 1)))
+    end
+    _atomic_store!(head, h + n, :release)
+    return n
+end
+
+function Base.push!(ring::ShmRing, x)
+    spins = 0
+    while !trypush!(ring, x)
+        spins = _backoff(spins)
+    end
+    return ring
+end
+
+function Base.append!(ring::ShmRing{T}, xs::AbstractVector{<:T}) where {T}
+    i0 = firstindex(xs) - 1
+    n = length(xs)
+    k = 0
+    spins = 0
+    while k < n
+        m = trypush!(ring, view(xs, i0+k+1:i0+n))
+        if m > 0
+            k += m
+            spins = 0
+        else
+            spins = _backoff(spins)
+        end
+    end
+    return ring
+end
+
+function Base.pop!(ring::ShmRing)
+    spins = 0
+    while true
+        val = trypop!(ring)
+        val === nothing || return val
+        spins = _backoff(spins)
+    end
+end
+
+function Base.read!(ring::ShmRing{T}, buf::AbstractVector{T}) where {T}
+    i0 = firstindex(buf) - 1
+    n = length(buf)
+    k = 0
+    spins = 0
+    while k < n
+        m = trypop!(ring, view(buf, i0+k+1:i0+n))
+        if m > 0
+            k += m
+            spins = 0
+        else
+            spins = _backoff(spins)
+        end
+    end
+    return buf
+end
+
+# Layout of a ring.  The header stores the magic number, the size of the
+# elements and the capacity of the ring and, each on its own cache line, the
+# index of the next value to pop (the head, only written by the consumer) and
+# the index of the next value to push (the tail, only written by the
+# producer).  The indices are never wrapped, the position of a value in the
+# ring is given by the index modulo the capacity.  The header is followed by
+# the values.
+const _RING_MAGIC = 0x474e49522d435049 # "IPC-RING" in little endian order
+const _RING_HEAD_OFFSET = 64
+const _RING_TAIL_OFFSET = 128
+const _RING_DATA_OFFSET = 192
+
+@inline _ring_head(base::Ptr) = Ptr{UInt64}(base + _RING_HEAD_OFFSET)
+@inline _ring_tail(base::Ptr) = Ptr{UInt64}(base + _RING_TAIL_OFFSET)
+@inline _ring_data(::ShmRing{T}, base::Ptr) where {T} =
+    Ptr{T}(base + _RING_DATA_OFFSET)
+
+# Yield the 1-based position in the ring of the value at index `i`.
+@inline _ring_index(ring::ShmRing, i::UInt64) =
+    Int(i & UInt64(ring.cap - 1)) + 1
+
+function _check_ring_eltype(::Type{T}) where {T}
+    isbitstype(T) && sizeof(T) ≥ 1 ||
+        throw_argument_error("illegal element type (", T, ")")
+    nothing
+end
@@ -16,7 +16,7 @@
 ## Named Semaphores
 
 ```julia
-Semaphore(name, value; perms=0o600, volatile=true) -> sem
+Semaphore(name, value; perms=0o600, volatile=true, cache=false) -> sem
 ```
 
 creates a new named semaphore identified by the string `name` of the form
@@ -26,11 +26,14 @@ permissions.  Keyword `volatile` specify whether the semaphore should be
 unlinked when the returned object is finalized.
 
 ```julia
-Semaphore(name) -> sem
+Semaphore(name; cache=false) -> sem
 ```
 
 opens an existing named semaphore and returns an instance of
-`Semaphore{String}`.
+`Semaphore{String}`.  If keyword `cache` is true, the object already open by
+this process for the same named semaphore is returned if any (see
+[`IPC.cachestats`](@ref)); this keyword can also be specified when creating a
+named semaphore to record it in the cache.
 
 To unlink (remove) a persistent named semaphore, simply do:
 
@@ -91,14 +94,19 @@ See also: [`post`](@ref), [`wait`](@ref), [`timedwait`](@ref),
 """
 function Semaphore(name::AbstractString, value::Integer;
                    perms::Integer = S_IRUSR | S_IWUSR,
-                   volatile::Bool = true)
+                   volatile::Bool = true,
+                   cache::Bool = false)
     val = _check_semaphore_value(value)
     mode = maskmode(perms)
     flags = O_CREAT | O_EXCL
-    return open(Semaphore, name, flags, mode, val, volatile)
+    sem = open(Semaphore, name, flags, mode, val, volatile)
+    return (cache ? _cache!(sem, :semaphore, sem.lnk, false) : sem)
 end
 
-function Semaphore(name::AbstractString)
+function Semaphore(name::AbstractString; cache::Bool = false)
+    if cache
+        return _cached(() -> Semaphore(name), :semaphore, String(name), false)
+    end
     flags = zero(Cint)
     mode = zero(_typeof_mode_t)
     value = zero(Cuint)
@@ -214,7 +222,7 @@ post(sem::Semaphore) =
 
 """
 ```julia
-wait(sem)
+wait(sem; async=false)
 ```
 
 decrements (locks) the semaphore `sem`.  If the semaphore's value is greater
@@ -225,11 +233,20 @@ rises above zero), or a signal handler interrupts the call (in which case an
 instance of `InterruptException` is thrown).  A `SystemError` may be thrown if
 an unexpected error occurs.
 
+If keyword `async` is true, the semaphore is polled by `trywait` with the
+calling task sleeping between attempts for an increasing delay (from 1 to 20
+milliseconds), so that only the calling task is suspended while other Julia
+tasks keep running on the calling thread.  No threads are tied up, so any
+number of asynchronous waits can be pending, at the cost of a latency of a
+few milliseconds.  For event driven waits without polling, see
+[`EventSemaphore`](@ref).
+
 See also: [`Semaphore`](@ref), [`post`](@ref), [`timedwait`](@ref),
           [`trywait`](@ref).
 
 """
-function Base.wait(sem::Semaphore)
+function Base.wait(sem::Semaphore; async::Bool = false)
+    async && return _async_wait(sem)
     if _sem_wait(sem.ptr) != SUCCESS
         code = Libc.errno()
         if code == Libc.EINTR
@@ -243,7 +260,7 @@ end
 
 """
 ```julia
-timedwait(sem, secs)
+timedwait(sem, secs; async=false)
 ```
 
 decrements (locks) the semaphore `sem`.  If the semaphore's value is greater
@@ -254,14 +271,17 @@ rises above zero), or the limit of `secs` seconds expires (in which case an
 instance of [`TimeoutError`](@ref) is thrown), or a signal handler interrupts
 the call (in which case an instance of `InterruptException` is thrown).
 
+Keyword `async` has the same meaning as for [`wait`](@ref).
+
 See also: [`Semaphore`](@ref), [`post`](@ref), [`wait`](@ref),
           [`trywait`](@ref).
 
 """
-Base.timedwait(sem::Semaphore, secs::Real) =
-    timedwait(sem::Semaphore, convert(Float64, secs))
+Base.timedwait(sem::Semaphore, secs::Real; kwds...) =
+    timedwait(sem::Semaphore, convert(Float64, secs); kwds...)
 
-function Base.timedwait(sem::Semaphore, secs::Float64)
+function Base.timedwait(sem::Semaphore, secs::Float64; async::Bool = false)
+    async && return _async_timedwait(sem, time() + secs)
     tsref = Ref{TimeSpec}(time() + secs)
     if _sem_timedwait(sem.ptr, tsref) != SUCCESS
         code = Libc.errno()
@@ -276,6 +296,33 @@ function Base.timedwait(sem::Semaphore, secs::Float64)
     nothing
 end
 
+# Asynchronous waits poll the semaphore, the calling task sleeping between
+# attempts for an exponentially increasing delay (in seconds).  Blocking waits
+# must not be performed by the helper threads of libuv as their number is
+# small and they are shared with other uses (e.g., `getaddrinfo`).
+const _ASYNC_MIN_DELAY = 0.001
+const _ASYNC_MAX_DELAY = 0.02
+
+function _async_wait(sem::Semaphore)
+    delay = _ASYNC_MIN_DELAY
+    while !trywait(sem)
+        sleep(delay)
+        delay = min(2*delay, _ASYNC_MAX_DELAY)
+    end
+    nothing
+end
+
+function _async_timedwait(sem::Semaphore, abstime::Float64)
+    delay = _ASYNC_MIN_DELAY
+    while !trywait(sem)
+        remaining = abstime - time()
+        remaining > 0 || throw(TimeoutError())
+        sleep(min(delay, remaining))
+        delay = min(2*delay, _ASYNC_MAX_DELAY)
+    end
+    nothing
+end
+
 """
 ```julia
 trywait(sem) -> boolean
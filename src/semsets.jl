@@ -0,0 +1,237 @@
+#
+# semsets.jl --
+#
+# Management of System V semaphore sets for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+SemaphoreSet(key, nsems; perms=0o600, volatile=true, value=0) -> set
+```
+
+creates a new System V semaphore set of `nsems` semaphores associated with the
+System V IPC key `key` (an instance of [`IPC.Key`](@ref), possibly
+`IPC.PRIVATE` for a set only shared with child processes).  All semaphores are
+initialized with value `value`.  Keyword `perms` can be used to specify access
+permissions (the default value warrants read and write permissions for the
+caller).  Keyword `volatile` specifies whether the semaphore set should be
+removed when the returned object is finalized.
+
+```julia
+SemaphoreSet(key) -> set
+```
+
+yields an instance of `SemaphoreSet` associated with the existing System V
+semaphore set identified by `key`.
+
+A semaphore set behaves as a vector of semaphores:
+
+```julia
+length(set) # yields the number of semaphores
+set[i]      # yields the value of the `i`-th semaphore
+set[:]      # yields the values of all semaphores
+set[i] = n  # sets the value of the `i`-th semaphore
+```
+
+Contrarily to POSIX semaphores ([`Semaphore`](@ref)), several semaphores of a
+set can be incremented and decremented by any amounts in a single atomic
+operation by [`IPC.semop`](@ref).  This is useful to acquire several resources
+at once without risks of deadlocks.  Also, the operations may be undone by the
+system when the process terminates, so the resources acquired by a crashed
+process are automatically released.
+
+To remove the semaphore set, call:
+
+```julia
+rm(set)
+```
+
+See also: [`IPC.semop`](@ref), [`IPC.SemInfo`](@ref).
+
+"""
+function SemaphoreSet(key::Key, nsems::Integer;
+                      perms::Integer = S_IRUSR | S_IWUSR,
+                      volatile::Bool = true,
+                      value::Integer = 0)
+    nsems ≥ 1 ||
+        throw_argument_error("invalid number of semaphores (", nsems, ")")
+    0 ≤ value ≤ SEMVMX ||
+        throw_argument_error("invalid semaphore value (", value, ")")
+    flags = maskmode(perms) | (S_IRUSR|S_IWUSR|IPC_CREAT|IPC_EXCL)
+    id = _semget(key.value, nsems, flags)
+    id < 0 && throw_system_error("semget")
+    vals = fill(Cushort(value), nsems)
+    if _semctl(id, 0, SETALL, vals) == -1
+        errno = Libc.errno()
+        _semctl(id, 0, IPC_RMID, C_NULL)
+        throw_system_error("semctl", errno)
+    end
+    set = SemaphoreSet(id, Int(nsems))
+    return (volatile ? finalizer(_destroy, set) : set)
+end
+
+function SemaphoreSet(key::Key)
+    id = _semget(key.value, 0, 0)
+    id < 0 && throw_system_error("semget")
+    buf = _workspace(_sizeof_struct_semid_ds)
+    systemerror("semctl", _semctl(id, 0, IPC_STAT, buf) == -1)
+    nsems = _peek(_typeof_sem_nsems, buf, _offsetof_sem_nsems)
+    return SemaphoreSet(id, Int(nsems))
+end
+
+# Remove a semaphore set.
+function _destroy(set::SemaphoreSet)
+    if (id = set.id) ≥ 0
+        set.id = -1 # to not remove twice
+        _semctl(id, 0, IPC_RMID, C_NULL)
+    end
+    nothing
+end
+
+function Base.rm(set::SemaphoreSet)
+    if (id = set.id) ≥ 0
+        set.id = -1 # to not remove twice
+        systemerror("semctl", _semctl(id, 0, IPC_RMID, C_NULL) == -1)
+    end
+    nothing
+end
+
+Base.length(set::SemaphoreSet) = set.nsems
+
+function Base.getindex(set::SemaphoreSet, i::Integer)
+    val = _semctl(_check_semid(set), _check_semnum(set, i), GETVAL, Cint(0))
+    val == -1 && throw_system_error("semctl")
+    return Int(val)
+end
+
+function Base.getindex(set::SemaphoreSet, ::Colon)
+    vals = Vector{Cushort}(undef, length(set))
+    systemerror("semctl", _semctl(_check_semid(set), 0, GETALL, vals) == -1)
+    return Int.(vals)
+end
+
+function Base.setindex!(set::SemaphoreSet, val::Integer, i::Integer)
+    0 ≤ val ≤ SEMVMX ||
+        throw_argument_error("invalid semaphore value (", val, ")")
+    systemerror("semctl",
+                _semctl(_check_semid(set), _check_semnum(set, i), SETVAL,
+                        Cint(val)) == -1)
+    return set
+end
+
+"""
+```julia
+IPC.semop(set, ops...; undo=false, nowait=false, timeout=Inf) -> bool
+```
+
+atomically performs the operations `ops...` on the semaphores of the System V
+semaphore set `set`.  Each operation is specified by a pair `i => n` with `i`
+the index of the semaphore and `n` the amount to add to its value.  If `n` is
+negative, the operation blocks until the value of the semaphore is greater or
+equal `abs(n)`; if `n` is zero, the operation blocks until the value of the
+semaphore is zero.  The operations are performed all at once and only when
+none of them blocks.  For example, to acquire one unit of semaphores 1 and 3
+and then release them:
+
+```julia
+IPC.semop(set, 1 => -1, 3 => -1)
+...
+IPC.semop(set, 1 => +1, 3 => +1)
+```
+
+If keyword `undo` is true, the operations are automatically undone by the
+system when the process terminates.  If keyword `nowait` is true, the call
+returns `false` instead of blocking.  Keyword `timeout` specifies the maximum
+time to wait (in seconds), the call returns `false` if the time limit expires
+(a finite timeout is only supported on Linux).  Otherwise, `true` is returned.
+An `InterruptException` is thrown if the call is interrupted by a signal.
+
+See also: [`SemaphoreSet`](@ref).
+
+"""
+function semop(set::SemaphoreSet, ops::Pair{<:Integer,<:Integer}...;
+               undo::Bool = false,
+               nowait::Bool = false,
+               timeout::Real = Inf)
+    n = length(ops)
+    n ≥ 1 || throw_argument_error("no operations")
+    id = _check_semid(set)
+    flg = (undo ? SEM_UNDO : zero(SEM_UNDO)) |
+        (nowait ? IPC_NOWAIT : zero(IPC_NOWAIT))
+    buf = _workspace(n*_sizeof_struct_sembuf)
+    for k in 1:n
+        i, op = ops[k]
+        typemin(_typeof_sem_op) ≤ op ≤ typemax(_typeof_sem_op) ||
+            throw_argument_error("invalid semaphore operation (", op, ")")
+        off = (k - 1)*_sizeof_struct_sembuf
+        _poke!(_typeof_sem_num, buf, off + _offsetof_sem_num,
+               _check_semnum(set, i))
+        _poke!(_typeof_sem_op,  buf, off + _offsetof_sem_op,  op)
+        _poke!(_typeof_sem_flg, buf, off + _offsetof_sem_flg, flg)
+    end
+    if isinf(timeout) && timeout > 0
+        res = _semop(id, buf, n)
+        name = "semop"
+    else
+        ts = Ref(TimeSpec(max(Float64(timeout), 0.0)))
+        res = _semtimedop(id, buf, n, ts)
+        name = "semtimedop"
+    end
+    if res == -1
+        code = Libc.errno()
+        if code == Libc.EAGAIN
+            return false
+        elseif code == Libc.EINTR
+            throw(InterruptException())
+        else
+            throw_system_error(name, code)
+        end
+    end
+    return true
+end
+
+"""
+```julia
+IPC.SemInfo(set) -> info
+```
+
+yields information about the System V semaphore set `set`.
+
+See also: [`SemaphoreSet`](@ref).
+
+"""
+function SemInfo(set::SemaphoreSet)
+    id = _check_semid(set)
+    buf = _workspace(_sizeof_struct_semid_ds)
+    systemerror("semctl", _semctl(id, 0, IPC_STAT, buf) == -1)
+    info = SemInfo()
+    info.otime = _peek(_typeof_time_t,        buf, _offsetof_sem_otime)
+    info.ctime = _peek(_typeof_time_t,        buf, _offsetof_sem_ctime)
+    info.nsems = _peek(_typeof_sem_nsems,     buf, _offsetof_sem_nsems)
+    info.id    = id
+    info.uid   = _peek(_typeof_uid_t,         buf, _offsetof_sem_perm_uid)
+    info.gid   = _peek(_typeof_gid_t,         buf, _offsetof_sem_perm_gid)
+    info.cuid  = _peek(_typeof_uid_t,         buf, _offsetof_sem_perm_cuid)
+    info.cgid  = _peek(_typeof_gid_t,         buf, _offsetof_sem_perm_cgid)
+    info.mode  = _peek(_typeof_sem_perm_mode, buf, _offsetof_sem_perm_mode)
+    return info
+end
+
+function _check_semid(set::SemaphoreSet)
+    set.id ≥ 0 || throw_error_exception("semaphore set has been removed")
+    return set.id
+end
+
+function _check_semnum(set::SemaphoreSet, i::Integer)
+    1 ≤ i ≤ length(set) ||
+        throw_argument_error("out of range semaphore index (", i, ")")
+    return Cint(i - 1)
+end
@@ -0,0 +1,234 @@
+#
+# seqlock.jl --
+#
+# Sequence locks protecting values or arrays in shared memory for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmSeqLock{T}(mem, dims; offset=0) -> lock
+```
+
+creates a new sequence lock protecting an array of values of type `T` and
+dimensions `dims` stored by memory object `mem` at relative position (in
+bytes) specified by keyword `offset`.  With `dims = ()`, the sequence lock
+protects a single value of type `T` (e.g. a structure).  The memory object is
+typically a [`SharedMemory`](@ref) so that the protected data can be used by
+several processes.  The element type must be a bits type and there may be at
+most 4 dimensions.  The protected data is initially filled with zero bytes.
+The number of bytes needed by the sequence lock is given by
+`sizeof(ShmSeqLock{T}, dims)`.
+
+```julia
+ShmSeqLock{T}(mem; offset=0) -> lock
+```
+
+yields an instance of `ShmSeqLock` associated with an existing sequence lock
+stored by memory object `mem` at relative position given by keyword `offset`.
+This is how other processes attach the sequence lock.
+
+The sequence lock may also be directly stored in new shared memory identified
+by `id` (see [`SharedMemory`](@ref) for a description of `id` and for keywords
+`kwds`) and retrieved by other processes with:
+
+```julia
+ShmSeqLock{T}(id, dims; kwds...) -> lock # create
+ShmSeqLock{T}(id; kwds...) -> lock       # attach
+```
+
+Readers get a consistent copy of the protected data with:
+
+```julia
+lock[] -> val      # the protected value or a copy of the protected array
+read!(lock, buf)   # copy the protected array into `buf`
+```
+
+while writers modify the protected data with:
+
+```julia
+lock[] = val       # set the protected value
+copyto!(lock, src) # set the protected array
+IPC.update!(f, lock)
+```
+
+where `IPC.update!(f, lock)` calls `f(A)` with `A` a [`WrappedArray`](@ref)
+sharing the memory of the protected data (a 0-dimensional array if the lock
+protects a single value) for the writer to modify it in place.
+
+A sequence lock has a sequence number which is odd while a writer is
+modifying the protected data.  Writers make it odd by a compare-and-swap, so
+concurrent writers are serialized, and even again when done.  Readers never
+write to the shared memory: they copy the protected data and retry if the
+sequence number was odd or has changed meanwhile.  Reading thus costs two
+atomic loads and does not slow down writers nor other readers.  Writers are
+never blocked by readers but readers may starve if the data is modified too
+often.  `f` must not throw nor block for too long as readers spin meanwhile.
+
+"""
+function ShmSeqLock{T}(mem::M, dims::NTuple{N,Integer};
+                       offset::Integer = 0) where {T,N,M}
+    _check_ring_eltype(T)
+    N ≤ _SEQLOCK_MAXDIMS ||
+        throw_argument_error("too many dimensions (", N, ")")
+    checkdims(dims)
+    len = sizeof(ShmSeqLock{T}, dims)
+    base = _shared_address(mem, offset, len)
+    ccall(:memset, Ptr{Cvoid}, (Ptr{Cvoid}, Cint, Csize_t), base, 0, len)
+    _poke!(UInt64, base + 8, sizeof(T))
+    _poke!(UInt64, base + 16, N)
+    for d in 1:N
+        _poke!(UInt64, base + 16 + 8d, dims[d])
+    end
+    _atomic_store!(Ptr{UInt64}(base + _SEQLOCK_SEQ_OFFSET), 0, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _SEQLOCK_MAGIC, :release)
+    return ShmSeqLock{T,N,M}(mem, offset, convert(NTuple{N,Int}, dims))
+end
+
+function ShmSeqLock{T}(mem::M; offset::Integer = 0) where {T,M}
+    _check_ring_eltype(T)
+    base = _shared_address(mem, offset, _SEQLOCK_DATA_OFFSET)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _SEQLOCK_MAGIC ||
+        throw_argument_error("no sequence lock at given offset")
+    _peek(UInt64, base + 8) == sizeof(T) ||
+        throw_argument_error("size of elements does not match")
+    N = Int(_peek(UInt64, base + 16))
+    N ≤ _SEQLOCK_MAXDIMS || throw_argument_error("corrupted sequence lock")
+    dims = ntuple(d -> Int(_peek(UInt64, base + 16 + 8d)), N)
+    _shared_address(mem, offset, sizeof(ShmSeqLock{T}, dims))
+    return ShmSeqLock{T,N,M}(mem, offset, dims)
+end
+
+function ShmSeqLock{T}(id::Union{AbstractString,ShmId,Key,File,
+                                 Type{FileDescriptor}},
+                       dims::Tuple{Vararg{Integer}}; kwds...) where {T}
+    mem = SharedMemory(id, sizeof(ShmSeqLock{T}, dims); kwds...)
+    return ShmSeqLock{T}(mem, dims)
+end
+
+ShmSeqLock{T}(id::Union{AbstractString,ShmId,Key,File,FileDescriptor};
+              kwds...) where {T} = ShmSeqLock{T}(SharedMemory(id; kwds...))
+
+Base.sizeof(::Type{<:ShmSeqLock{T}}, dims::Tuple{Vararg{Integer}}) where {T} =
+    _SEQLOCK_DATA_OFFSET + sizeof(T)*prod(dims; init=1)
+
+Base.eltype(::Type{<:ShmSeqLock{T}}) where {T} = T
+Base.size(lock::ShmSeqLock) = lock.dims
+Base.length(lock::ShmSeqLock) = prod(lock.dims; init=1)
+Base.pointer(lock::ShmSeqLock) = pointer(lock.mem) + lock.off
+
+# Yield the addresses of the sequence number and of the protected data.
+@inline _seqlock_seq(base::Ptr) = Ptr{UInt64}(base + _SEQLOCK_SEQ_OFFSET)
+@inline _seqlock_data(::ShmSeqLock{T}, base::Ptr) where {T} =
+    Ptr{T}(base + _SEQLOCK_DATA_OFFSET)
+
+# Read the protected data by calling `f(ptr)` until a consistent result is
+# obtained.
+@inline function _seqlock_read(f::Function, lock::ShmSeqLock)
+    base = pointer(lock)
+    seq = _seqlock_seq(base)
+    spins = 0
+    while true
+        s = _atomic_load(seq, :acquire)
+        if isodd(s)
+            spins = _backoff(spins)
+            continue
+        end
+        val = f(_seqlock_data(lock, base))
+        # Make sure that the data has been read before checking the sequence
+        # number again.
+        _atomic_fence(:acquire)
+        _atomic_load(seq, :monotonic) == s && return val
+        spins = _backoff(spins)
+    end
+end
+
+# Modify the protected data by calling `f(ptr)` while owning the lock.
+@inline function _seqlock_write(f::Function, lock::ShmSeqLock)
+    base = pointer(lock)
+    seq = _seqlock_seq(base)
+    s = _atomic_load(seq, :monotonic)
+    spins = 0
+    while true
+        if isodd(s)
+            spins = _backoff(spins)
+            s = _atomic_load(seq, :monotonic)
+            continue
+        end
+        s, ok = _atomic_cas!(seq, s, s + 1, :acquire_release)
+        ok && break
+    end
+    # Make sure that the sequence number is odd before modifying the data,
+    # this pairs with the acquire fence of the readers.
+    _atomic_fence(:release)
+    try
+        return f(_seqlock_data(lock, base))
+    finally
+        _atomic_store!(seq, s + 2, :release)
+    end
+end
+
+Base.getindex(lock::ShmSeqLock{T,0}) where {T} =
+    _seqlock_read(unsafe_load, lock)
+
+Base.getindex(lock::ShmSeqLock{T,N}) where {T,N} =
+    read!(lock, Array{T,N}(undef, lock.dims))
+
+function Base.read!(lock::ShmSeqLock{T}, buf::DenseArray{T}) where {T}
+    length(buf) == length(lock) ||
+        throw(DimensionMismatch("buffer must have $(length(lock)) elements"))
+    n = length(buf)
+    GC.@preserve buf _seqlock_read(lock) do ptr
+        unsafe_copyto!(pointer(buf), ptr, n)
+    end
+    return buf
+end
+
+function Base.setindex!(lock::ShmSeqLock{T,0}, val) where {T}
+    x = convert(T, val)
+    _seqlock_write(ptr -> unsafe_store!(ptr, x), lock)
+    return lock
+end
+
+function Base.copyto!(lock::ShmSeqLock{T}, src::DenseArray{T}) where {T}
+    length(src) == length(lock) ||
+        throw(DimensionMismatch("source must have $(length(lock)) elements"))
+    n = length(src)
+    GC.@preserve src _seqlock_write(lock) do ptr
+        unsafe_copyto!(ptr, pointer(src), n)
+    end
+    return lock
+end
+
+"""
+```julia
+IPC.update!(f, lock) -> f(A)
+```
+
+calls `f(A)` with `A` a [`WrappedArray`](@ref) sharing the memory of the data
+protected by the sequence lock `lock` while owning the lock for writing.
+
+See [`ShmSeqLock`](@ref) for details.
+
+"""
+function update!(f::Function, lock::ShmSeqLock{T}) where {T}
+    A = WrappedArray(lock.mem, T, lock.dims;
+                     offset = lock.off + _SEQLOCK_DATA_OFFSET)
+    return _seqlock_write(ptr -> f(A), lock)
+end
+
+# Layout of a sequence lock.  The header stores the magic number, the size of
+# the elements, the number of dimensions and the dimensions and, on the next
+# cache line, the sequence number.  The header is followed by the protected
+# data.
+const _SEQLOCK_MAGIC = 0x4c5145532d435049 # "IPC-SEQL" in little endian order
+const _SEQLOCK_MAXDIMS = 4
+const _SEQLOCK_SEQ_OFFSET = 64
+const _SEQLOCK_DATA_OFFSET = 128
@@ -15,42 +15,107 @@
 
 """
 ```julia
-SharedMemory(id, len; perms=0o600, volatile=true)
+SharedMemory(id, len; perms=0o600, volatile=true, growable=false,
+             hugepages=false, prefault=false, lock=false, numa=nothing,
+             address=nothing)
 ```
 
 yields a new shared memory object identified by `id` and whose size is `len`
 bytes.  The identifier `id` can be a string starting by a `'/'` to create a
 POSIX shared memory object or a System V IPC key to create a System V shared
 memory segment.  In this latter case, the key can be `IPC.PRIVATE` to
-automatically create a non-existing shared memory segment.
+automatically create a non-existing shared memory segment.  The identifier `id`
+can also be `FileDescriptor` to create anonymous shared memory (with
+`memfd_create`, Linux only) which has no name and can be shared with other
+processes by sending its file descriptor over a Unix domain socket (see
+[`IPC.sendfd`](@ref)).  Keyword `name` can be used to specify the name of
+anonymous shared memory, the name is only used for debugging (e.g., in
+`/proc/self/maps`).  Finally, the identifier `id` can be `IPC.File(path)` to
+create a new regular file of `len` bytes at `path` and map it in memory; such
+file-backed shared memory persists on disk (see [`IPC.File`](@ref)).
 
 Keyword `perms` can be used to specify which access permissions are granted.
-By default, only reading and writing by the user is granted.
+By default, only reading and writing by the user is granted.  Keywords `perms`
+and `volatile` are not applicable to anonymous shared memory.
 
 Keyword `volatile` can be used to specify whether the shared memory is volatile
 or not.  If non-volatile, the shared memory will remain accessible until
 explicit destruction or system reboot.  By default, the shared memory is
 destroyed when no longer in use.
 
+Keyword `growable` can be set true to create POSIX or anonymous shared memory
+whose size can be changed later by calling `resize!(shm, len)`, other
+processes sharing the memory automatically follow the changes (see
+[`resize!`](@ref resize!(::SharedMemory,::Integer))).  Growable shared memory
+starts with a small header which is hidden to the user, other processes must
+retrieve it with keyword `growable=true` (see below).
+
+Keyword `hugepages` can be set true to request that the shared memory be
+backed by huge pages (Linux only).  For a System V shared memory segment or for
+anonymous shared memory, the memory is created with flag `SHM_HUGETLB` or
+`MFD_HUGETLB` and its size is rounded up to a multiple of the huge page size
+(see [`IPC.hugepagesize`](@ref)); this requires that enough huge pages have
+been reserved by the system administrator.  For a POSIX shared memory object,
+transparent huge pages are requested by `madvise(MADV_HUGEPAGE)`; this is only
+effective if `/sys/kernel/mm/transparent_hugepage/shmem_enabled` allows it and
+transparent huge pages are only obtained when the pages are faulted-in (see
+keyword `prefault`).  In any case, call `IPC.pagesize(shm)` to figure out which
+page size has actually been obtained.
+
+Keyword `prefault` can be set true to fault-in all the pages of the shared
+memory when it is mapped (with `MAP_POPULATE` if possible, otherwise by
+touching every page with all available threads).  Keyword `lock` can be set
+true to lock the pages in RAM so that they cannot be swapped out (with
+`mlock` for a POSIX shared memory object or when attaching an existing
+System V segment, and with `shmctl(id, SHM_LOCK)` when creating a System V
+segment).  Locked pages are also faulted-in.  These keywords are meant to have
+the cost of page faults paid at setup rather than during the first accesses to
+the shared memory.  Locking memory is subject to the `RLIMIT_MEMLOCK` resource
+limit and, for `SHM_LOCK`, to the ownership of the segment.
+
+Keyword `numa` can be used to specify the NUMA placement policy of the pages
+of the shared memory (see [`IPC.mempolicy!`](@ref) for possible values).  The
+policy is set before the pages are faulted-in.
+
+Keyword `address` can be used to specify the address at which the shared
+memory must be mapped in the address space of the caller, so that cooperating
+processes can map the same memory at the same address and store ordinary
+pointers in it (otherwise, see [`ShmPtr`](@ref)).  The address must be a
+multiple of the page size (for System V shared memory segments, of `SHMLBA`).
+The mapping is done with `MAP_FIXED_NOREPLACE` or with the `shmaddr` argument
+of `shmat`, so a `SystemError` is thrown if any part of the requested address
+range is already in use; existing mappings are never replaced.  Growable shared
+memory cannot be mapped at a fixed address.
+
 To retrieve an existing shared memory object, call:
 
 ```julia
-SharedMemory(id; readonly=false)
+SharedMemory(id; readonly=false, growable=false, prefault=false, lock=false,
+             numa=nothing, cache=false, address=nothing)
 ```
 
-where `id` is the shared memory identifier (a string, an IPC key or a System V
-IPC identifier of shared memory segment as returned by `ShmId`).  Keyword
-`readonly` can be set true if only read access is needed.  Note that method
-`shmid(obj)` may be called to retrieve the identifier of the shared memory
-object `obj`.
+where `id` is the shared memory identifier (a string, an IPC key, a System V
+IPC identifier of shared memory segment as returned by `ShmId` or the file
+descriptor of anonymous shared memory, for instance received by
+[`IPC.recvfd`](@ref)).  Keyword `readonly` can be set true if only read access
+is needed.  Keyword `growable` must be set true to retrieve growable POSIX or
+anonymous shared memory, an `ArgumentError` is thrown if the shared memory
+does not start with the header of growable shared memory; otherwise, the
+shared memory is mapped as is and cannot be resized.  Keyword `cache` can be
+set true to reuse the object already mapped by this process for the same named
+shared memory or System V segment and the same access, if any (see
+[`IPC.cachestats`](@ref)); the cache is not used if keyword `address` is
+specified.  Note that method `shmid(obj)` may be called to retrieve the
+identifier of the shared memory object `obj`.
 
 Some methods are extended for shared memory objects.  Assuming `shm` is an
 instance of `SharedMemory`, then:
 
 ```julia
-pointer(shm)    # yields the base address of the shared memory
-sizeof(shm)     # yields the number of bytes of the shared memory
-shmid(shm)      # yields the identifier the shared memory
+pointer(shm)      # yields the base address of the shared memory
+sizeof(shm)       # yields the number of bytes of the shared memory
+shmid(shm)        # yields the identifier the shared memory
+IPC.pagesize(shm) # yields the size of the pages backing the shared memory
 ```
 
 To ensure that shared memory object `shm` is eventually destroyed, call:
@@ -64,73 +129,175 @@ See also [`shmid`](@ref), [`shmrm`](@ref).
 """
 function SharedMemory(key::Key, len::Integer;
                       perms::Integer = S_IRUSR|S_IWUSR,
-                      volatile::Bool = true)::SharedMemory{ShmId}
+                      volatile::Bool = true,
+                      hugepages::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      cache::Bool = false,
+                      address = nothing)::SharedMemory{ShmId}
     # Create a new System V shared memory segment with given size and, at
     # least, read and write access for the caller.
     len ≥ 1 || throw_argument_error("bad number of bytes (", len, ")")
+    pol = (numa === nothing ? nothing : MemPolicy(numa))
+    addr = _fixed_address(address)
     flags = maskmode(perms) | (S_IRUSR|S_IWUSR|IPC_CREAT|IPC_EXCL)
+    if hugepages
+        # Segments backed by huge pages must have a size which is a multiple
+        # of the huge page size.
+        flags |= _shm_hugetlb_flag()
+        len = roundup(len, hugepagesize())
+    end
     id = _shmget(key.value, len, flags)
     if id < 0
         throw_system_error("shmget")
     end
 
     # Attach shared memory segment to process address space.
-    ptr = _shmat(id, C_NULL, 0)
+    ptr = _shmat(id, addr, 0)
     if ptr == Ptr{Cvoid}(-1)
         errno = Libc.errno()
         _shmctl(id, IPC_RMID, C_NULL)
         throw_system_error("shmat", errno)
     end
+    if pol !== nothing && _set_mempolicy(ptr, len, pol, false) != SUCCESS
+        errno = Libc.errno()
+        _shmdt(ptr)
+        _shmctl(id, IPC_RMID, C_NULL)
+        throw_system_error("mbind", errno)
+    end
     if volatile && _shmctl(id, IPC_RMID, C_NULL) == -1
         errno = Libc.errno()
         _shmdt(ptr)
         throw_system_error("shmctl", errno)
     end
 
-    # Instanciate Julia object.
-    return SharedMemory{ShmId}(ptr, len, volatile, ShmId(id))
+    # Lock the segment in memory and/or fault-in its pages (`SHM_LOCK` does
+    # not fault-in the pages).
+    if lock && _shmctl(id, _shm_lock_cmd(), C_NULL) == -1
+        errno = Libc.errno()
+        _shmdt(ptr)
+        volatile || _shmctl(id, IPC_RMID, C_NULL)
+        throw_system_error("shmctl", errno)
+    end
+    if prefault || lock
+        _prefault(ptr, len)
+    end
+
+    # Instanciate Julia object.  The page size is left unknown (zero) so that
+    # it is determined from the effective mapping if queried.
+    obj = SharedMemory{ShmId}(ptr, len, volatile, ShmId(id), 0)
+    return (cache ? _cache!(obj, :sysv, obj.id, false) : obj)
 end
 
 SharedMemory(key::Key; readonly::Bool = false, kwds...) =
     SharedMemory(ShmId(key, readonly); kwds...)
 
-function SharedMemory(id::ShmId; readonly::Bool=false)::SharedMemory{ShmId}
+function SharedMemory(id::ShmId;
+                      readonly::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      cache::Bool = false,
+                      address = nothing)::SharedMemory{ShmId}
+    if cache && address === nothing
+        return _cached(:sysv, id, readonly) do
+            SharedMemory(id; readonly = readonly, prefault = prefault,
+                         lock = lock, numa = numa)
+        end
+    end
+    pol = (numa === nothing ? nothing : MemPolicy(numa))
+    addr = _fixed_address(address)
     len = sizeof(id)
-    ptr = shmat(id, readonly)
-    return SharedMemory{ShmId}(ptr, len, false, id)
+    ptr = _shmat(id.value, addr, (readonly ? SHM_RDONLY : zero(SHM_RDONLY)))
+    systemerror("shmat", ptr == Ptr{Cvoid}(-1))
+    if pol !== nothing && _set_mempolicy(ptr, len, pol, false) != SUCCESS
+        errno = Libc.errno()
+        _shmdt(ptr)
+        throw_system_error("mbind", errno)
+    end
+    if lock && _mlock(ptr, len) != SUCCESS
+        errno = Libc.errno()
+        _shmdt(ptr)
+        throw_system_error("mlock", errno)
+    end
+    if prefault && !lock
+        _prefault(ptr, len)
+    end
+    return SharedMemory{ShmId}(ptr, len, false, id, 0)
 end
 
 # Create a new POSIX shared memory object.
 function SharedMemory(name::AbstractString,
                       len::Integer;
                       perms::Integer = S_IRUSR | S_IWUSR,
-                      volatile::Bool = true) :: SharedMemory{String}
+                      volatile::Bool = true,
+                      growable::Bool = false,
+                      hugepages::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      cache::Bool = false,
+                      address = nothing) :: SharedMemory{String}
     # Make sure owner has read and write permissions (otherwise setting the
     # size will fail).
     mode = maskmode(perms) | (S_IRUSR | S_IWUSR)
     flags = O_CREAT | O_EXCL | O_RDWR
-    return SharedMemory(name, flags, mode, len, volatile)
+    obj = SharedMemory(name, flags, mode, len, volatile;
+                       growable = growable, hugepages = hugepages,
+                       prefault = prefault, lock = lock, numa = numa,
+                       address = address)
+    return (cache ? _cache!(obj, _posix_cache_kind(growable), obj.id, false) :
+            obj)
 end
 
 # Map an existing POSIX shared memory object.
 function SharedMemory(name::AbstractString;
-                      readonly::Bool=false) :: SharedMemory{String}
+                      readonly::Bool = false,
+                      growable::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      cache::Bool = false,
+                      address = nothing) :: SharedMemory{String}
+    if cache && address === nothing
+        return _cached(_posix_cache_kind(growable), String(name), readonly) do
+            SharedMemory(name; readonly = readonly, growable = growable,
+                         prefault = prefault, lock = lock, numa = numa)
+        end
+    end
     flags = (readonly ? O_RDONLY : O_RDWR)
     mode = (readonly ? S_IRUSR : S_IRUSR|S_IWUSR)
-    return SharedMemory(name, flags, mode, 0, false)
+    return SharedMemory(name, flags, mode, 0, false;
+                        growable = growable, prefault = prefault,
+                        lock = lock, numa = numa, address = address)
 end
 
+# Growable and plain views of the same POSIX shared memory differ, so they are
+# cached separately.
+_posix_cache_kind(growable::Bool) = (growable ? :posix_growable : :posix)
+
 function SharedMemory(name::AbstractString,
                       flags::Integer,
                       mode::Integer,
                       len::Integer = 0,
-                      volatile::Bool = false)
+                      volatile::Bool = false;
+                      growable::Bool = false,
+                      hugepages::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      address = nothing)
 
     # Create a new POSIX shared memory object?
     create = ((flags & O_CREAT) != 0)
     if create
         len ≥ 1 || throw_argument_error("bad number of bytes (", len, ")")
     end
+    pol = (numa === nothing ? nothing : MemPolicy(numa))
+    addr = _fixed_address(address)
+    growable && addr != C_NULL && throw_argument_error(
+        "growable shared memory cannot be mapped at a fixed address")
 
     # Open shared memory and set or get its size.
     fd = _shm_open(name, flags, mode)
@@ -139,14 +306,15 @@ function SharedMemory(name::AbstractString,
     end
     local nbytes::Int = 0
     if create
-        # Set the size of the new shared memory object.
-        if _ftruncate(fd, len) != SUCCESS
+        # Set the size of the new shared memory object (accounting for the
+        # header of growable shared memory).
+        nbytes = Int(len) + (growable ? _SHM_HEADER_SIZE : 0)
+        if _ftruncate(fd, nbytes) != SUCCESS
             errno = Libc.errno()
             _close(fd)
             _shm_unlink(name)
             throw_system_error("ftruncate", errno)
         end
-        nbytes = Int(len)
     else
         # Get the size of the existing shared memory object.
         try
@@ -162,14 +330,14 @@ function SharedMemory(name::AbstractString,
     prot = (access == O_RDONLY ? PROT_READ :
             access == O_WRONLY ? PROT_WRITE :
             access == O_RDWR   ? PROT_READ|PROT_WRITE : PROT_NONE)
-    ptr = _mmap(C_NULL, nbytes, prot, MAP_SHARED, fd, 0)
-    if ptr == MAP_FAILED
-        errno = Libc.errno()
+    ptr, pagesize = try
+        _map_shared(fd, nbytes, prot, hugepages, prefault, lock, pol, addr)
+    catch err
         _close(fd)
         if create
             _shm_unlink(name)
         end
-        throw_system_error("mmap", errno)
+        rethrow(err)
     end
 
     # File descriptor can be closed.
@@ -178,19 +346,274 @@ function SharedMemory(name::AbstractString,
         if create
             _shm_unlink(name)
         end
-        _munmap(ptr, len)
+        _munmap(ptr, nbytes)
+        throw_system_error("close", errno)
+    end
+
+    # Return the shared memory object, skipping the header of growable shared
+    # memory.
+    gen = (!growable ? -1 : create ? _init_growable!(ptr, nbytes) :
+           _probe_growable(ptr, nbytes, prot))
+    if growable && gen < 0
+        _munmap(ptr, nbytes)
+        throw_argument_error("shared memory \"", name, "\" is not growable")
+    end
+    off = (gen ≥ 0 ? _SHM_HEADER_SIZE : 0)
+    return SharedMemory{String}(ptr + off, nbytes - off, volatile, String(name),
+                                pagesize, gen)
+end
+
+# Create a new file-backed shared memory object.
+function SharedMemory(file::File,
+                      len::Integer;
+                      perms::Integer = S_IRUSR | S_IWUSR,
+                      volatile::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      address = nothing) :: SharedMemory{File}
+    flags = O_CREAT | O_EXCL | O_RDWR
+    return SharedMemory(file, flags, maskmode(perms), len, volatile;
+                        prefault = prefault, lock = lock, numa = numa,
+                        address = address)
+end
+
+# Map an existing file.
+function SharedMemory(file::File;
+                      readonly::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      address = nothing) :: SharedMemory{File}
+    flags = (readonly ? O_RDONLY : O_RDWR)
+    return SharedMemory(file, flags, 0, 0, false;
+                        prefault = prefault, lock = lock, numa = numa,
+                        address = address)
+end
+
+function SharedMemory(file::File,
+                      flags::Integer,
+                      mode::Integer,
+                      len::Integer = 0,
+                      volatile::Bool = false;
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      address = nothing) :: SharedMemory{File}
+    # Create a new file?
+    create = ((flags & O_CREAT) != 0)
+    if create
+        len ≥ 1 || throw_argument_error("bad number of bytes (", len, ")")
+    end
+    pol = (numa === nothing ? nothing : MemPolicy(numa))
+    addr = _fixed_address(address)
+
+    # Open the file and set or get its size.
+    fd = _open(file.path, flags, mode)
+    if fd == -1
+        throw_system_error("open")
+    end
+    local nbytes::Int = 0
+    if create
+        if _ftruncate(fd, len) != SUCCESS
+            errno = Libc.errno()
+            _close(fd)
+            _unlink(file.path)
+            throw_system_error("ftruncate", errno)
+        end
+        nbytes = Int(len)
+    else
+        try
+            nbytes = Int(filesize(fd))
+        catch err
+            _close(fd)
+            rethrow(err)
+        end
+        if nbytes < 1
+            _close(fd)
+            throw_argument_error("cannot map empty file \"", file.path, "\"")
+        end
+    end
+
+    # Map the file.
+    access = flags & (O_RDONLY|O_WRONLY|O_RDWR)
+    prot = (access == O_RDONLY ? PROT_READ : PROT_READ|PROT_WRITE)
+    ptr, pagesize = try
+        _map_shared(fd, nbytes, prot, false, prefault, lock, pol, addr)
+    catch err
+        _close(fd)
+        if create
+            _unlink(file.path)
+        end
+        rethrow(err)
+    end
+
+    # File descriptor can be closed, the mapping remains valid.
+    if _close(fd) != SUCCESS
+        errno = Libc.errno()
+        _munmap(ptr, nbytes)
+        if create
+            _unlink(file.path)
+        end
         throw_system_error("close", errno)
     end
+    return SharedMemory{File}(ptr, nbytes, volatile, file, pagesize)
+end
+
+# Create a new anonymous shared memory object.
+function SharedMemory(::Type{FileDescriptor},
+                      len::Integer;
+                      name::AbstractString = "julia-ipc",
+                      growable::Bool = false,
+                      hugepages::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      address = nothing) :: SharedMemory{FileDescriptor}
+    len ≥ 1 || throw_argument_error("bad number of bytes (", len, ")")
+    growable && hugepages && throw_argument_error(
+        "growable anonymous shared memory cannot be backed by huge pages")
+    pol = (numa === nothing ? nothing : MemPolicy(numa))
+    addr = _fixed_address(address)
+    growable && addr != C_NULL && throw_argument_error(
+        "growable shared memory cannot be mapped at a fixed address")
+    flags = _mfd_cloexec_flag()
+    if hugepages
+        # Anonymous files backed by huge pages must have a size which is a
+        # multiple of the huge page size.
+        flags |= _mfd_hugetlb_flag()
+        len = roundup(len, hugepagesize())
+    end
+    fd = _memfd_create(name, flags)
+    if fd == -1
+        throw_system_error("memfd_create")
+    end
+    nbytes = Int(len) + (growable ? _SHM_HEADER_SIZE : 0)
+    if _ftruncate(fd, nbytes) != SUCCESS
+        errno = Libc.errno()
+        _close(fd)
+        throw_system_error("ftruncate", errno)
+    end
+    ptr, pagesize = try
+        _map_shared(fd, nbytes, PROT_READ|PROT_WRITE, false, prefault, lock,
+                    pol, addr)
+    catch err
+        _close(fd)
+        rethrow(err)
+    end
+
+    # The file descriptor is kept open so that it can be sent to other
+    # processes.
+    gen = (growable ? _init_growable!(ptr, nbytes) : -1)
+    off = (gen ≥ 0 ? _SHM_HEADER_SIZE : 0)
+    return SharedMemory{FileDescriptor}(ptr + off, nbytes - off, false,
+                                        FileDescriptor(fd),
+                                        (hugepages ? hugepagesize() : pagesize),
+                                        gen)
+end
+
+# Map an anonymous shared memory object given its file descriptor (a duplicate
+# of the file descriptor is owned by the returned object).
+function SharedMemory(fd::FileDescriptor;
+                      readonly::Bool = false,
+                      growable::Bool = false,
+                      prefault::Bool = false,
+                      lock::Bool = false,
+                      numa = nothing,
+                      address = nothing) :: SharedMemory{FileDescriptor}
+    isopen(fd) || throw_argument_error("file descriptor has been closed")
+    pol = (numa === nothing ? nothing : MemPolicy(numa))
+    addr = _fixed_address(address)
+    growable && addr != C_NULL && throw_argument_error(
+        "growable shared memory cannot be mapped at a fixed address")
+    nbytes = Int(filesize(fd))
+    nbytes ≥ 1 || throw_argument_error("bad number of bytes (", nbytes, ")")
+    dup = _dup(fd.fd)
+    if dup == -1
+        throw_system_error("dup")
+    end
+    prot = (readonly ? PROT_READ : PROT_READ|PROT_WRITE)
+    ptr, pagesize = try
+        _map_shared(dup, nbytes, prot, false, prefault, lock, pol, addr)
+    catch err
+        _close(dup)
+        rethrow(err)
+    end
+
+    # The page size is left unknown (zero) as the memory may have been created
+    # with huge pages.
+    gen = (growable ? _probe_growable(ptr, nbytes, prot) : -1)
+    if growable && gen < 0
+        _munmap(ptr, nbytes)
+        _close(dup)
+        throw_argument_error("anonymous shared memory is not growable")
+    end
+    off = (gen ≥ 0 ? _SHM_HEADER_SIZE : 0)
+    return SharedMemory{FileDescriptor}(ptr + off, nbytes - off, false,
+                                        FileDescriptor(dup), 0, gen)
+end
+
+# Map `nbytes` of the shared memory open as `fd` with protection `prot`, then
+# apply the advice, NUMA policy, locking and prefaulting options.  If `addr` is
+# not null, the memory is mapped at this address or not at all.  Yields the
+# address of the mapping and its page size.  On error, the memory is unmapped
+# and a `SystemError` is thrown, the file descriptor being left open.
+function _map_shared(fd::Integer, nbytes::Int, prot::Integer,
+                     hugepages::Bool, prefault::Bool, lock::Bool, pol,
+                     addr::Ptr{Cvoid} = C_NULL)
+    # If the pages are to be prefaulted and no advice nor policy has to be
+    # given before the pages are faulted-in, let `mmap` populate the mapping.
+    populate = (prefault && !lock && !hugepages && pol === nothing &&
+                _map_populate_flag() != 0)
+    mflags = (populate ? MAP_SHARED|_map_populate_flag() : MAP_SHARED)
+    if addr != C_NULL
+        mflags |= _map_fixed_noreplace_flag()
+    end
+    ptr = _mmap(addr, nbytes, prot, mflags, fd, 0)
+    if ptr == MAP_FAILED
+        throw_system_error("mmap")
+    end
+    if addr != C_NULL && ptr != addr
+        # The requested address has only been taken as a hint (not all systems
+        # implement `MAP_FIXED_NOREPLACE`), so it must be in use.
+        _munmap(ptr, nbytes)
+        throw_system_error("mmap", Libc.EEXIST)
+    end
+
+    # Request transparent huge pages for the mapping.  This is only advisory.
+    advised = hugepages && _advise_hugepages(ptr, nbytes)
+
+    # Set the NUMA placement policy.
+    if pol !== nothing && _set_mempolicy(ptr, nbytes, pol, false) != SUCCESS
+        errno = Libc.errno()
+        _munmap(ptr, nbytes)
+        throw_system_error("mbind", errno)
+    end
 
-    # Return the shared memory object.
-    return SharedMemory{String}(ptr, nbytes, volatile, String(name))
+    # Lock the pages in memory (this also faults them in) and/or prefault
+    # them.
+    if lock && _mlock(ptr, nbytes) != SUCCESS
+        errno = Libc.errno()
+        _munmap(ptr, nbytes)
+        throw_system_error("mlock", errno)
+    end
+    if prefault && !lock && !populate
+        _prefault(ptr, nbytes)
+    end
+
+    # Transparent huge pages are only obtained when the pages are faulted-in,
+    # so the page size is measured if the pages have been faulted-in and is
+    # otherwise left unknown (zero) to be measured when queried.
+    pagesize = (!advised ? Int(PAGE_SIZE) :
+                (prefault || lock) ? _mapping_pagesize(ptr) : 0)
+    return ptr, pagesize
 end
 
 function _destroy(obj::SharedMemory{String})
     if obj.volatile
         _shm_unlink(obj.id)
     end
-    _munmap(obj.ptr, obj.len)
+    _munmap(_mapped_region(obj)...)
     if PARANOID
         obj.ptr = C_NULL
         obj.len = 0
@@ -199,6 +622,27 @@ function _destroy(obj::SharedMemory{String})
     end
 end
 
+function _destroy(obj::SharedMemory{FileDescriptor})
+    _munmap(_mapped_region(obj)...)
+    _close(obj.id)
+    if PARANOID
+        obj.ptr = C_NULL
+        obj.len = 0
+    end
+end
+
+function _destroy(obj::SharedMemory{File})
+    _munmap(obj.ptr, obj.len)
+    if obj.volatile
+        _unlink(obj.id.path)
+    end
+    if PARANOID
+        obj.ptr = C_NULL
+        obj.len = 0
+        obj.volatile = false
+    end
+end
+
 function _destroy(obj::SharedMemory{ShmId})
     _shmdt(obj.ptr)
     if PARANOID
@@ -209,8 +653,522 @@ function _destroy(obj::SharedMemory{ShmId})
     end
 end
 
-Base.sizeof(obj::SharedMemory) = obj.len
-Base.pointer(obj::SharedMemory) = obj.ptr
+Base.sizeof(obj::SharedMemory) = (obj.gen < 0 ? obj.len : _refresh!(obj).len)
+Base.pointer(obj::SharedMemory) = (obj.gen < 0 ? obj.ptr : _refresh!(obj).ptr)
+
+"""
+```julia
+resize!(shm, len) -> shm
+```
+
+resizes the shared memory object `shm` so that it provides `len` bytes.  The
+contents of the shared memory is preserved up to the smallest of the former
+and new sizes, bytes beyond the former size are zero.  Only shared memory
+created with keyword `growable=true` can be resized (see
+[`SharedMemory`](@ref)).  System V shared memory segments cannot be resized.
+
+Growable shared memory starts with a small header storing its current size and
+a generation number which is incremented by each resizing.  The object backing
+the shared memory is resized with `ftruncate` and the mapping with `mremap`
+(Linux only).  Other processes attached to the same shared memory with keyword
+`growable=true` detect the change and remap their view lazily, on their next
+call to `pointer(shm)` or `sizeof(shm)`, so that checking for a change only
+costs an atomic read.
+
+Since the mapping may move, any pointer or array obtained for `shm` (for
+instance a [`WrappedArray`](@ref)) must no longer be used after `shm` has been
+resized by this or another process: call `pointer(shm)` again.  When shrinking,
+the caller must make sure that other processes no longer access the truncated
+part.  Concurrent resizings of the same shared memory must be avoided and the
+caller must have mapped the shared memory for reading and writing.
+
+"""
+function Base.resize!(obj::SharedMemory{<:Union{String,FileDescriptor}},
+                      len::Integer)
+    obj.gen ≥ 0 || throw_argument_error("shared memory is not growable")
+    len ≥ 1 || throw_argument_error("bad number of bytes (", len, ")")
+    _refresh!(obj)
+    oldlen = obj.len
+    newlen = Int(len)
+    newlen == oldlen && return obj
+
+    # When growing, the object backing the shared memory must be enlarged
+    # before being remapped.  When shrinking, it is truncated after other
+    # processes have been notified.
+    if newlen > oldlen
+        _truncate_shared(obj, newlen + _SHM_HEADER_SIZE)
+    end
+    hdr = obj.ptr - _SHM_HEADER_SIZE
+    ptr = _mremap(hdr, oldlen + _SHM_HEADER_SIZE, newlen + _SHM_HEADER_SIZE,
+                  _mremap_maymove_flag())
+    if ptr == MAP_FAILED
+        throw_system_error("mremap")
+    end
+    obj.ptr = ptr + _SHM_HEADER_SIZE
+    obj.len = newlen
+    _atomic_store!(Ptr{Int64}(ptr + _SHM_LEN_OFFSET), newlen, :monotonic)
+    obj.gen = Int(_atomic_add!(Ptr{UInt64}(ptr + _SHM_GEN_OFFSET), 1,
+                               :release)) + 1
+    if newlen < oldlen
+        _truncate_shared(obj, newlen + _SHM_HEADER_SIZE)
+    end
+    return obj
+end
+
+Base.resize!(obj::SharedMemory{ShmId}, len::Integer) =
+    throw_error_exception("System V shared memory segments cannot be resized")
+
+Base.resize!(obj::SharedMemory{File}, len::Integer) =
+    throw_error_exception("file-backed shared memory cannot be resized")
+
+"""
+```julia
+IPC.File(path)
+```
+
+yields an identifier of the regular file `path` to be used as the backing
+storage of shared memory.  Then:
+
+```julia
+shm = SharedMemory(IPC.File(path), len; perms=0o600, volatile=false)
+```
+
+creates a new file of `len` bytes (an error is thrown if the file already
+exists) and maps it in memory, while:
+
+```julia
+shm = SharedMemory(IPC.File(path); readonly=false)
+```
+
+maps all the contents of an existing file in memory.  In both cases, the
+mapping is shared (with `MAP_SHARED`) so that the modifications are visible by
+all processes mapping the same file and are eventually written back to the
+file.  Contrarily to other kinds of shared memory, file-backed shared memory is
+not volatile by default, that is the file is not deleted when `shm` is
+finalized.  Keywords `prefault`, `lock` and `numa` have the same meaning as for
+other kinds of shared memory (see [`SharedMemory`](@ref)); setting `prefault`
+true is a fast means to load the whole file in memory.
+
+Large shared arrays can thus be made persistent:
+
+```julia
+A = WrappedArray(IPC.File(path), Float64, dims) # create the file
+...
+flush(A)                                       # write back the modifications
+...
+B = WrappedArray(IPC.File(path))                # map it again, later
+```
+
+See also: [`flush`](@ref flush(::SharedMemory)).
+
+""" File
+
+"""
+```julia
+flush(shm; async=false, invalidate=false)
+```
+
+flushes the modifications made to the shared memory object `shm` to the
+backing storage with `msync`.  This is only useful for file-backed shared
+memory (see [`IPC.File`](@ref)), the operation is harmless otherwise.  By
+default, the call blocks until the data has been written.  If keyword `async` is
+true, the write back is only scheduled and the call returns immediately.  If
+keyword `invalidate` is true, other mappings of the same file are invalidated
+so that they see the new data.
+
+```julia
+flush(shm, rng; async=false, invalidate=false)
+```
+
+only flushes the bytes of `shm` whose indices are in the range `rng` (the
+first byte of `shm` has index 1).  As the granularity of `msync` is the memory
+page, all the pages overlapping `rng` are flushed.
+
+```julia
+flush(A; async=false, invalidate=false)
+```
+
+flushes the memory pages storing the elements of a wrapped array `A` whose
+contents is stored in shared memory.
+
+"""
+Base.flush(obj::SharedMemory; kwds...) =
+    _flush(pointer(obj), sizeof(obj); kwds...)
+
+function Base.flush(obj::SharedMemory, rng::AbstractUnitRange{<:Integer};
+                    kwds...)
+    isempty(rng) && return nothing
+    1 ≤ first(rng) && last(rng) ≤ sizeof(obj) ||
+        throw_argument_error("out of range bytes")
+    return _flush(pointer(obj) + (first(rng) - 1), length(rng); kwds...)
+end
+
+Base.flush(A::WrappedArray{T,N,<:SharedMemory}; kwds...) where {T,N} =
+    _flush(pointer(A), sizeof(A); kwds...)
+
+function _flush(ptr::Ptr, len::Integer;
+                async::Bool = false,
+                invalidate::Bool = false)
+    # The address must be a multiple of the page size.
+    off, cnt = _page_range(ptr, len)
+    flags = ((async ? MS_ASYNC : MS_SYNC) |
+             (invalidate ? MS_INVALIDATE : zero(MS_INVALIDATE)))
+    systemerror("msync", _msync(ptr - off, cnt*PAGE_SIZE, flags) != SUCCESS)
+    nothing
+end
+
+"""
+```julia
+IPC.advise!(obj, [rng,] advice) -> obj
+```
+
+advises the kernel about the expected use of the memory backing object `obj`
+(with `madvise`) so that it can choose appropriate paging strategies.  Object
+`obj` can be a [`SharedMemory`](@ref) object, a [`WrappedArray`](@ref) or any
+object implementing `pointer(obj)` and `sizeof(obj)`.  If optional argument
+`rng` is specified, the advice only applies to the bytes of a shared memory
+object or to the elements of a wrapped array whose (linear) indices are in the
+range `rng`.  Argument `advice` is one of:
+
+* `:normal` for no special treatment (the default);
+
+* `:sequential` to expect sequential accesses, pages are aggressively read
+  ahead (this is mostly useful for file-backed shared memory, see
+  [`IPC.File`](@ref)) and may be freed soon after being accessed;
+
+* `:random` to expect accesses in random order, read ahead is disabled;
+
+* `:willneed` to expect accesses in the near future, the pages are read ahead
+  without blocking the caller;
+
+* `:dontneed` to not expect accesses in the near future, the pages are
+  released which reduces the resident memory of the caller.  The contents of
+  shared memory is preserved (it is reloaded from the backing object on next
+  access) and other processes are not affected, but the contents of private
+  memory (e.g. a `DynamicMemory`) is lost and replaced by zeros;
+
+* `:hugepage` to request transparent huge pages (Linux only, see keyword
+  `hugepages` of [`SharedMemory`](@ref)).
+
+As the granularity of `madvise` is the memory page, the advice applies to all
+the pages overlapping the specified memory, except for `:dontneed` which only
+applies to the pages entirely inside the specified memory (nothing is done if
+there are none) so that the bytes outside the specified memory are never
+lost.
+
+See also: [`IPC.mempolicy!`](@ref).
+
+"""
+function advise!(obj, advice::Symbol)
+    ptr, len = get_memory_parameters(obj)
+    _advise(ptr, len, advice)
+    return obj
+end
+
+function advise!(obj::SharedMemory, rng::AbstractUnitRange{<:Integer},
+                 advice::Symbol)
+    isempty(rng) || (1 ≤ first(rng) && last(rng) ≤ sizeof(obj)) ||
+        throw_argument_error("out of range bytes")
+    _advise(pointer(obj) + (first(rng) - 1), length(rng), advice)
+    return obj
+end
+
+function advise!(A::WrappedArray{T}, rng::AbstractUnitRange{<:Integer},
+                 advice::Symbol) where {T}
+    isempty(rng) || checkbounds(A, rng)
+    _advise(pointer(A) + (first(rng) - 1)*sizeof(T), length(rng)*sizeof(T),
+            advice)
+    return A
+end
+
+function _advise(ptr::Ptr, len::Integer, advice::Symbol)
+    adv = _madv(advice) # check advice first
+    len > 0 || return nothing
+    if advice === :dontneed
+        # Releasing the pages of private memory zero-fills them, so only the
+        # pages entirely inside the specified memory are released.
+        start = roundup(convert(Int, ptr), PAGE_SIZE)
+        stop = div(convert(Int, ptr) + Int(len), PAGE_SIZE)*PAGE_SIZE
+        stop > start || return nothing
+        systemerror("madvise", _madvise(Ptr{Cvoid}(start), stop - start,
+                                        adv) != SUCCESS)
+    else
+        off, cnt = _page_range(ptr, len)
+        systemerror("madvise",
+                    _madvise(ptr - off, cnt*PAGE_SIZE, adv) != SUCCESS)
+    end
+    nothing
+end
+
+@static if isdefined(@__MODULE__, :MADV_NORMAL)
+    _madv(advice::Symbol) =
+        (advice == :normal     ? MADV_NORMAL     :
+         advice == :sequential ? MADV_SEQUENTIAL :
+         advice == :random     ? MADV_RANDOM     :
+         advice == :willneed   ? MADV_WILLNEED   :
+         advice == :dontneed   ? MADV_DONTNEED   :
+         advice == :hugepage   ? _madv_hugepage() :
+         throw_argument_error("unknown memory advice `:", advice, "`"))
+else
+    _madv(advice::Symbol) =
+        throw_error_exception("memory advices are not supported on this system")
+end
+
+@static if isdefined(@__MODULE__, :MADV_HUGEPAGE)
+    _madv_hugepage() = MADV_HUGEPAGE
+else
+    _madv_hugepage() =
+        throw_error_exception("huge pages are not supported on this system")
+end
+
+# Layout of the header of growable shared memory.  The header size is that of
+# a cache line so that the data remains suitably aligned.
+const _SHM_HEADER_SIZE = 64
+const _SHM_MAGIC = 0x574f52472d435049 # "IPC-GROW" in little endian order
+const _SHM_GEN_OFFSET = 8  # offset of the generation number (UInt64)
+const _SHM_LEN_OFFSET = 16 # offset of the size of the data (Int64)
+
+# Initialize the header of growable shared memory mapped at `ptr` with
+# `nbytes` bytes (header included) and yield the initial generation number.
+# The generation number starts at 1 so that 0 can be used to force a refresh.
+function _init_growable!(ptr::Ptr{Cvoid}, nbytes::Int)
+    _poke!(UInt64, ptr, _SHM_MAGIC)
+    _atomic_store!(Ptr{Int64}(ptr + _SHM_LEN_OFFSET),
+                   nbytes - _SHM_HEADER_SIZE, :monotonic)
+    _atomic_store!(Ptr{UInt64}(ptr + _SHM_GEN_OFFSET), 1, :release)
+    return 1
+end
+
+# Yield 0 if the mapping at `ptr` with `nbytes` bytes and protection `prot`
+# starts with the header of growable shared memory, -1 otherwise.  The size of
+# the mapping may be out of date, 0 is returned to force a refresh.  This is
+# only used to validate the header when keyword `growable` is set, plain
+# shared memory is never taken for growable one whatever its contents.
+_probe_growable(ptr::Ptr{Cvoid}, nbytes::Int, prot::Integer) =
+    (nbytes ≥ _SHM_HEADER_SIZE && (prot & PROT_READ) != 0 &&
+     _peek(UInt64, ptr) == _SHM_MAGIC ? 0 : -1)
+
+# Update the mapping of growable shared memory if it has been resized.
+function _refresh!(obj::SharedMemory)
+    hdr = obj.ptr - _SHM_HEADER_SIZE
+    gen = Int(_atomic_load(Ptr{UInt64}(hdr + _SHM_GEN_OFFSET), :acquire))
+    if gen != obj.gen
+        len = Int(_atomic_load(Ptr{Int64}(hdr + _SHM_LEN_OFFSET), :monotonic))
+        if len != obj.len
+            ptr = _mremap(hdr, obj.len + _SHM_HEADER_SIZE,
+                          len + _SHM_HEADER_SIZE, _mremap_maymove_flag())
+            if ptr == MAP_FAILED
+                throw_system_error("mremap")
+            end
+            obj.ptr = ptr + _SHM_HEADER_SIZE
+            obj.len = len
+        end
+        obj.gen = gen
+    end
+    return obj
+end
+
+# Yield the address and size of the whole mapping of a shared memory object.
+_mapped_region(obj::SharedMemory) =
+    (obj.gen < 0 ? (obj.ptr, obj.len) :
+     (obj.ptr - _SHM_HEADER_SIZE, obj.len + _SHM_HEADER_SIZE))
+
+# Set the size of the object backing shared memory.
+function _truncate_shared(obj::SharedMemory{String}, len::Integer)
+    fd = _shm_open(obj.id, O_RDWR, 0)
+    if fd == -1
+        throw_system_error("shm_open")
+    end
+    if _ftruncate(fd, len) != SUCCESS
+        errno = Libc.errno()
+        _close(fd)
+        throw_system_error("ftruncate", errno)
+    end
+    _close(fd)
+    nothing
+end
+
+_truncate_shared(obj::SharedMemory{FileDescriptor}, len::Integer) =
+    systemerror("ftruncate", _ftruncate(obj.id.fd, len) != SUCCESS)
+
+@static if isdefined(@__MODULE__, :MREMAP_MAYMOVE)
+    _mremap_maymove_flag() = MREMAP_MAYMOVE
+else
+    _mremap_maymove_flag() =
+        throw_error_exception("resizing shared memory is not supported on this system")
+end
+
+"""
+```julia
+IPC.pagesize(shm) -> siz
+```
+
+yields the size (in bytes) of the memory pages backing the shared memory object
+`shm`.  This can be used to check whether a shared memory object created with
+keyword `hugepages=true` is effectively backed by huge pages.  For transparent
+huge pages, the result reflects the pages faulted-in when the size was first
+measured: at creation if the memory was prefaulted or locked, otherwise at
+the first call to `IPC.pagesize`.
+
+```julia
+IPC.hugepagesize() -> siz
+```
+
+yields the default size (in bytes) of huge pages on this system or
+`IPC.PAGE_SIZE` if huge pages are not supported.
+
+See also: [`SharedMemory`](@ref).
+
+"""
+function pagesize(obj::SharedMemory)
+    if obj.pagesize ≤ 0
+        obj.pagesize = _mapping_pagesize(first(_mapped_region(obj)))
+    end
+    return obj.pagesize
+end
+
+function hugepagesize()
+    @static if Sys.islinux()
+        if isfile("/proc/meminfo")
+            for line in eachline("/proc/meminfo")
+                if startswith(line, "Hugepagesize:")
+                    return 1024*parse(Int, split(line)[2])
+                end
+            end
+        end
+    end
+    return Int(PAGE_SIZE)
+end
+
+@doc @doc(pagesize) hugepagesize
+
+@static if isdefined(@__MODULE__, :SHM_HUGETLB)
+    _shm_hugetlb_flag() = SHM_HUGETLB
+else
+    _shm_hugetlb_flag() =
+        throw_error_exception("huge pages are not supported on this system")
+end
+
+# Advise the kernel to back a mapping by transparent huge pages and yield
+# whether the advice was accepted.  For shared memory (`tmpfs`), transparent
+# huge pages are only used if permitted by the system settings and only once
+# the pages are faulted-in.
+function _advise_hugepages(ptr::Ptr, len::Integer)
+    @static if isdefined(@__MODULE__, :MADV_HUGEPAGE)
+        return _madvise(ptr, len, MADV_HUGEPAGE) == SUCCESS
+    else
+        return false
+    end
+end
+
+# Yield the size of transparent huge pages.
+function _thp_pagesize()
+    path = "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"
+    if isfile(path)
+        siz = tryparse(Int, strip(read(path, String)))
+        siz === nothing || return siz
+    end
+    return hugepagesize()
+end
+
+@static if isdefined(@__MODULE__, :SYS_memfd_create)
+    _mfd_cloexec_flag() = MFD_CLOEXEC
+else
+    _mfd_cloexec_flag() = zero(Cuint)
+end
+
+@static if isdefined(@__MODULE__, :MFD_HUGETLB)
+    _mfd_hugetlb_flag() = MFD_HUGETLB
+else
+    _mfd_hugetlb_flag() =
+        throw_error_exception("huge pages are not supported on this system")
+end
+
+@static if isdefined(@__MODULE__, :MAP_POPULATE)
+    _map_populate_flag() = MAP_POPULATE
+else
+    _map_populate_flag() = zero(Cint)
+end
+
+@static if isdefined(@__MODULE__, :MAP_FIXED_NOREPLACE)
+    _map_fixed_noreplace_flag() = MAP_FIXED_NOREPLACE
+else
+    _map_fixed_noreplace_flag() = zero(Cint)
+end
+
+# Check the value of keyword `address` and yield it as a pointer (null if
+# unspecified).
+_fixed_address(::Nothing) = C_NULL
+function _fixed_address(addr::Union{Ptr,Integer})
+    ptr = Ptr{Cvoid}(UInt(addr))
+    (ptr != C_NULL && rem(UInt(ptr), UInt(PAGE_SIZE)) == 0) ||
+        throw_argument_error("address must be a nonzero multiple of the ",
+                             "page size")
+    return ptr
+end
+_fixed_address(addr) = throw_argument_error("invalid address ", repr(addr))
+
+@static if isdefined(@__MODULE__, :SHM_LOCK)
+    _shm_lock_cmd() = SHM_LOCK
+else
+    _shm_lock_cmd() =
+        throw_error_exception("locking System V shared memory segments is not supported on this system")
+end
+
+# Fault-in all the pages of the mapping at address `ptr` by reading one byte
+# per page.  Reading is sufficient for shared memory (pages are allocated on
+# first access whatever its kind) and cannot clobber the contents.  The pages
+# are split in contiguous chunks processed by the available threads.  The
+# result is returned so that the reads cannot be optimized out.
+function _prefault(ptr::Ptr, len::Integer)
+    step = Int(PAGE_SIZE)
+    npages = div(Int(len) + step - 1, step)
+    nchunks = min(Threads.nthreads(), npages)
+    sums = zeros(UInt8, nchunks)
+    base = convert(Ptr{UInt8}, ptr)
+    Threads.@threads for c in 1:nchunks
+        s = zero(UInt8)
+        for i in div((c - 1)*npages, nchunks):div(c*npages, nchunks) - 1
+            s ⊻= unsafe_load(base + i*step)
+        end
+        sums[c] = s
+    end
+    return reduce(⊻, sums; init = zero(UInt8))
+end
+
+# Yield the size of the kernel pages backing the mapping starting at address
+# `ptr`.
+function _mapping_pagesize(ptr::Ptr)
+    @static if Sys.islinux()
+        path = "/proc/self/smaps"
+        if isfile(path)
+            addr = convert(UInt, ptr)
+            found = false
+            pagesize = 0
+            for line in eachline(path)
+                if (i = findfirst(isequal('-'), line)) !== nothing &&
+                    (start = tryparse(UInt, line[1:i-1], base=16)) !== nothing
+                    # Header line of a mapping: "start-end perms offset ...".
+                    found && break
+                    found = (start == addr)
+                elseif found
+                    if startswith(line, "KernelPageSize:")
+                        pagesize = 1024*parse(Int, split(line)[2])
+                    elseif (startswith(line, "ShmemPmdMapped:") ||
+                            startswith(line, "FilePmdMapped:")) &&
+                        parse(Int, split(line)[2]) > 0
+                        # Transparent huge pages are mapped by the page middle
+                        # directory while `KernelPageSize` remains the size of
+                        # base pages.
+                        return _thp_pagesize()
+                    end
+                end
+            end
+            pagesize > 0 && return pagesize
+        end
+    end
+    return Int(PAGE_SIZE)
+end
 
 # The short version of `show` if also used for string interpolation in
 # scripts so that it is not necessary to extend methods:
@@ -221,6 +1179,17 @@ Base.show(io::IO, obj::SharedMemory{String}) =
     print(io, "SharedMemory(\"", obj.id, "\"; len=", obj.len,
           ", ptr=Ptr{Cvoid}(0x", string(convert(Int, obj.ptr), base=16),"))")
 
+Base.show(io::IO, obj::SharedMemory{FileDescriptor}) =
+    print(io, "SharedMemory(FileDescriptor(", obj.id.fd, "); len=", obj.len,
+          ", ptr=Ptr{Cvoid}(0x", string(convert(Int, obj.ptr), base=16),"))")
+
+Base.show(io::IO, obj::SharedMemory{File}) =
+    print(io, "SharedMemory(", obj.id, "; len=", obj.len,
+          ", ptr=Ptr{Cvoid}(0x", string(convert(Int, obj.ptr), base=16),"))")
+
+Base.show(io::IO, file::File) = print(io, "IPC.File(", repr(file.path), ")")
+Base.show(io::IO, ::MIME"text/plain", file::File) = show(io, file)
+
 Base.show(io::IO, obj::SharedMemory{ShmId}) =
     print(io, "SharedMemory(", obj.id, "; len=", obj.len,
           ", ptr=Ptr{Cvoid}(0x", string(convert(Int, obj.ptr), base=16),"))")
@@ -250,18 +1219,25 @@ can be:
 
 * An instance of `ShmId` to specify a System V shared memory segment.
 
+* An instance of `FileDescriptor` to specify anonymous shared memory.
+
+* An instance of `IPC.File` to specify file-backed shared memory.
+
 See also: [`SharedMemory`](@ref), [`shmrm`](@ref).
 
 """
 shmid(shm::SharedMemory) = shm.id
 shmid(arr::WrappedArray{T,N,<:SharedMemory}) where {T,N} = shmid(arr.mem)
 shmid(id::ShmId) = id
+shmid(fd::FileDescriptor) = fd
+shmid(file::File) = file
 shmid(key::Key, args...) = ShmId(key, args...)
 
 Base.rm(shm::SharedMemory) = shmrm(shm)
 Base.rm(id::ShmId) = shmrm(id)
 Base.rm(::Type{SharedMemory}, key::Key) = shmrm(key)
 Base.rm(::Type{SharedMemory}, name::AbstractString) = shmrm(name)
+Base.rm(::Type{SharedMemory}, file::File) = shmrm(file)
 
 """
 
@@ -284,6 +1260,11 @@ rm(id)                  # `id` is the identifier of a BSD shared memory segment
 rm(shm)                 # `shm` is an instance of `SharedMemory`
 ```
 
+Removing anonymous shared memory (created by `SharedMemory(FileDescriptor,
+len)`) has no effect: such memory is destroyed when no longer used.  Removing
+file-backed shared memory (identified by an instance of `IPC.File`) deletes the
+file.
+
 See also: [`SharedMemory`](@ref), [`shmid`](@ref), [`shmat`](@ref).
 
 """
@@ -299,6 +1280,19 @@ shmrm(name::AbstractString) = begin
     end
 end
 
+shmrm(file::File) = begin
+    if _unlink(file.path) != SUCCESS
+        errno = Libc.errno()
+        if errno != Libc.ENOENT
+            throw_system_error("unlink", errno)
+        end
+    end
+end
+
+# Anonymous shared memory is automatically destroyed when no longer mapped nor
+# referenced by any file descriptor.
+shmrm(::FileDescriptor) = nothing
+
 shmrm(id::ShmId) = begin
     if _shmrm(name) != SUCCESS
         # Only throw an error if not an already removed shared memory segment.
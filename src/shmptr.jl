@@ -0,0 +1,105 @@
+#
+# shmptr.jl --
+#
+# Position-independent pointers to data in shared memory for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+# Types of memory objects against which relative pointers can be resolved.
+const _ShmPtrMemory = Union{SharedMemory,DynamicMemory,WrappedArray}
+
+"""
+```julia
+ShmPtr{T}(off) -> p
+```
+
+yields a relative pointer to a value of type `T` stored at offset `off` (in
+bytes) relative to the base address of a memory object, typically a
+[`SharedMemory`](@ref).  Shared memory is mapped at different addresses by
+different processes, so ordinary pointers cannot be stored in shared memory,
+but relative pointers can.  As a result, linked lists, trees, indices, etc.
+can be built directly in shared memory.  A relative pointer is resolved by the
+memory object `mem` it refers to, a `SharedMemory`, a `DynamicMemory` or a
+`WrappedArray`:
+
+```julia
+pointer(mem, p) -> ptr::Ptr{T}
+unsafe_load(mem, p, i=1) -> val
+unsafe_store!(mem, p, val, i=1)
+```
+
+An offset of 0 is used for null relative pointers, `ShmPtr{T}()` yields a
+null relative pointer and `IPC.isnull(p)` checks whether `p` is null.
+`pointer(mem, p)` yields a null pointer if `p` is null.  Since blocks
+allocated by an arena never start at offset 0, the offsets returned by
+[`IPC.alloc!`](@ref) can be directly used to build relative pointers:
+
+```julia
+p = ShmPtr{T}(IPC.alloc!(arena, sizeof(T)))
+```
+
+A relative pointer can also be built from an address in the memory object
+`mem` by:
+
+```julia
+ShmPtr{T}(mem, ptr) -> p
+```
+
+As for ordinary pointers, adding or subtracting an integer to a relative
+pointer moves it by this number of bytes, `ShmPtr{T}(p)` converts relative
+pointer `p` to another type of value and `Int(p)` yields the offset of `p`.
+
+Relative pointers are bits types of the same size as ordinary pointers and
+their resolution amounts to adding the offset to `pointer(mem)`.  No bounds
+checking is performed, hence the `unsafe_` prefix of the methods to access
+the values.
+
+"""
+ShmPtr{T}(p::ShmPtr) where {T} = ShmPtr{T}(p.off)
+
+@inline ShmPtr{T}(mem::_ShmPtrMemory, ptr::Ptr) where {T} =
+    ShmPtr{T}(ptr == C_NULL ? 0 :
+              convert(Int, ptr) - convert(Int, pointer(mem)))
+
+Base.Int(p::ShmPtr) = p.off
+Base.convert(::Type{Int}, p::ShmPtr) = p.off
+Base.convert(::Type{ShmPtr{T}}, p::ShmPtr) where {T} = ShmPtr{T}(p)
+
+Base.:(+)(p::ShmPtr{T}, n::Integer) where {T} = ShmPtr{T}(p.off + n)
+Base.:(+)(n::Integer, p::ShmPtr) = p + n
+Base.:(-)(p::ShmPtr{T}, n::Integer) where {T} = ShmPtr{T}(p.off - n)
+
+"""
+```julia
+IPC.isnull(p) -> bool
+```
+
+yields whether relative pointer `p` is null.
+
+See also: [`ShmPtr`](@ref).
+
+"""
+isnull(p::ShmPtr) = iszero(p.off)
+
+@inline Base.pointer(mem::_ShmPtrMemory, p::ShmPtr{T}) where {T} =
+    ifelse(isnull(p), Ptr{T}(0), Ptr{T}(pointer(mem) + p.off))
+
+@inline Base.unsafe_load(mem::_ShmPtrMemory, p::ShmPtr, i::Integer = 1) =
+    unsafe_load(pointer(mem, p), i)
+
+@inline function Base.unsafe_store!(mem::_ShmPtrMemory, p::ShmPtr, val,
+                                   i::Integer = 1)
+    unsafe_store!(pointer(mem, p), val, i)
+    return p
+end
+
+Base.show(io::IO, p::ShmPtr{T}) where {T} =
+    print(io, "ShmPtr{", T, "}(", p.off, ")")
+Base.show(io::IO, ::MIME"text/plain", p::ShmPtr) = show(io, p)
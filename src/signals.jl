@@ -331,14 +331,15 @@ function sigwait!(mask::SigSet, info::SigInfo, timeout::TimeSpec)
 end
 
 _sigwait(mask::Ref{SigSet}, signum::Ref{Cint}) =
-    ccall(:sigwait, Cint, (Ptr{Cvoid}, Ptr{Cint}), mask, signum)
+    @gcsafe ccall(:sigwait, Cint, (Ptr{Cvoid}, Ptr{Cint}), mask, signum)
 
 _sigwaitinfo(set::Ref{SigSet}, info::Ref{SigInfo}) =
-    ccall(:sigwaitinfo, Cint, (Ptr{SigSet}, Ptr{SigInfo}), set, info)
+    @gcsafe ccall(:sigwaitinfo, Cint, (Ptr{SigSet}, Ptr{SigInfo}), set, info)
 
 _sigtimedwait(set::Ref{SigSet}, info::Ref{SigInfo}, timeout::Ref{TimeSpec}) =
-    ccall(:sigtimedwait, Cint, (Ptr{SigSet}, Ptr{SigInfo}, Ptr{TimeSpec}),
-          set, info, timeout)
+    @gcsafe ccall(:sigtimedwait, Cint,
+                  (Ptr{SigSet}, Ptr{SigInfo}, Ptr{TimeSpec}),
+                  set, info, timeout)
 
 function _sigtimedwait_timeout(secs::Real)
     isnan(secs) && throw_argument_error("number of seconds is NaN")
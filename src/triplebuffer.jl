@@ -0,0 +1,223 @@
+#
+# triplebuffer.jl --
+#
+# Triple buffers for exchanging the latest value between processes for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+ShmTripleBuffer{T}(mem, dims; offset=0) -> tb
+```
+
+creates a new triple buffer, that is three arrays of values of type `T` and
+dimensions `dims`, stored by memory object `mem` at relative position (in
+bytes) specified by keyword `offset`.  The memory object is typically a
+[`SharedMemory`](@ref) so that a producer and a consumer living in different
+processes can exchange the latest version of the arrays (e.g. images of a
+camera).  The element type must be a bits type and there may be at most 4
+dimensions.  The number of bytes needed by the triple buffer is given by
+`sizeof(ShmTripleBuffer{T}, dims)`.
+
+```julia
+ShmTripleBuffer{T}(mem; offset=0) -> tb
+```
+
+yields an instance of `ShmTripleBuffer` associated with an existing triple
+buffer stored by memory object `mem` at relative position given by keyword
+`offset`.  This is how the other process attaches the triple buffer.
+
+The triple buffer may also be directly stored in new shared memory identified
+by `id` (see [`SharedMemory`](@ref) for a description of `id` and for keywords
+`kwds`) and retrieved by the other process with:
+
+```julia
+ShmTripleBuffer{T}(id, dims; kwds...) -> tb # create
+ShmTripleBuffer{T}(id; kwds...) -> tb       # attach
+```
+
+The producer writes the next version of the data and publishes it with:
+
+```julia
+A = IPC.claim!(tb) # get the array owned by the producer
+...                # write the data in A
+IPC.publish!(tb)   # publish A
+```
+
+while the consumer gets the latest published version with:
+
+```julia
+A = IPC.tryfetch(tb) # get the latest version if new or nothing
+A = fetch(tb)        # get the latest version, new or not
+```
+
+The arrays are [`WrappedArray`](@ref) objects directly sharing the memory of
+the buffers (no copies are involved).  The array returned to the consumer is
+owned by the consumer until its next call to `IPC.tryfetch` or `fetch` that
+yields a new version; the array returned to the producer is owned by the
+producer until its next call to `IPC.publish!`.
+
+At any time, one buffer is owned by the producer, one by the consumer and the
+third one holds the latest published version.  Publishing and fetching a new
+version amount to exchanging the index of the owned buffer with that of the
+third buffer by a single atomic operation, a bit being set when a new version
+is published and cleared when it is fetched.  Hence neither the producer nor
+the consumer ever waits for the other, the producer never overwrites a version
+being read and the consumer always gets the most recent version.  There must
+be a single producer and a single consumer.
+
+"""
+function ShmTripleBuffer{T}(mem::M, dims::NTuple{N,Integer};
+                            offset::Integer = 0) where {T,N,M}
+    _check_ring_eltype(T)
+    N ≤ _SEQLOCK_MAXDIMS ||
+        throw_argument_error("too many dimensions (", N, ")")
+    checkdims(dims)
+    base = _shared_address(mem, offset, sizeof(ShmTripleBuffer{T}, dims))
+    _poke!(UInt64, base + 8, sizeof(T))
+    _poke!(UInt64, base + 16, N)
+    for d in 1:N
+        _poke!(UInt64, base + 16 + 8d, dims[d])
+    end
+    _atomic_store!(_tribuf_back(base), 0, :monotonic)
+    _atomic_store!(_tribuf_state(base), 1, :monotonic)
+    _atomic_store!(_tribuf_front(base), 2, :monotonic)
+    _atomic_store!(Ptr{UInt64}(base), _TRIBUF_MAGIC, :release)
+    return _tribuf(T, mem, offset, convert(NTuple{N,Int}, dims))
+end
+
+function ShmTripleBuffer{T}(mem::M; offset::Integer = 0) where {T,M}
+    _check_ring_eltype(T)
+    base = _shared_address(mem, offset, _TRIBUF_DATA_OFFSET)
+    _atomic_load(Ptr{UInt64}(base), :acquire) == _TRIBUF_MAGIC ||
+        throw_argument_error("no triple buffer at given offset")
+    _peek(UInt64, base + 8) == sizeof(T) ||
+        throw_argument_error("size of elements does not match")
+    N = Int(_peek(UInt64, base + 16))
+    N ≤ _SEQLOCK_MAXDIMS || throw_argument_error("corrupted triple buffer")
+    dims = ntuple(d -> Int(_peek(UInt64, base + 16 + 8d)), N)
+    _shared_address(mem, offset, sizeof(ShmTripleBuffer{T}, dims))
+    return _tribuf(T, mem, offset, dims)
+end
+
+function ShmTripleBuffer{T}(id::Union{AbstractString,ShmId,Key,File,
+                                      Type{FileDescriptor}},
+                            dims::Tuple{Vararg{Integer}}; kwds...) where {T}
+    mem = SharedMemory(id, sizeof(ShmTripleBuffer{T}, dims); kwds...)
+    return ShmTripleBuffer{T}(mem, dims)
+end
+
+ShmTripleBuffer{T}(id::Union{AbstractString,ShmId,Key,File,FileDescriptor};
+                   kwds...) where {T} =
+    ShmTripleBuffer{T}(SharedMemory(id; kwds...))
+
+Base.sizeof(::Type{<:ShmTripleBuffer{T}},
+            dims::Tuple{Vararg{Integer}}) where {T} =
+    _TRIBUF_DATA_OFFSET + 3*_tribuf_stride(T, dims)
+
+Base.eltype(::Type{<:ShmTripleBuffer{T}}) where {T} = T
+Base.size(tb::ShmTripleBuffer) = size(tb.bufs[1])
+Base.pointer(tb::ShmTripleBuffer) = pointer(tb.mem) + tb.off
+
+"""
+```julia
+IPC.claim!(tb) -> A
+```
+
+yields the array owned by the producer of the triple buffer `tb` to write the
+next version of the data.
+
+See [`ShmTripleBuffer`](@ref) for details.
+
+"""
+function claim!(tb::ShmTripleBuffer)
+    i = _atomic_load(_tribuf_back(pointer(tb)), :monotonic)
+    return tb.bufs[(i & 3) + 1]
+end
+
+"""
+```julia
+IPC.publish!(tb) -> tb
+```
+
+publishes the array owned by the producer of the triple buffer `tb` and gives
+another array to the producer.
+
+See [`ShmTripleBuffer`](@ref) for details.
+
+"""
+function publish!(tb::ShmTripleBuffer)
+    base = pointer(tb)
+    back = _tribuf_back(base)
+    i = _atomic_load(back, :monotonic)
+    old = _atomic_xchg!(_tribuf_state(base), i | _TRIBUF_DIRTY,
+                        :acquire_release)
+    _atomic_store!(back, old & 3, :monotonic)
+    return tb
+end
+
+"""
+```julia
+IPC.tryfetch(tb) -> A_or_nothing
+```
+
+yields the latest version of the data published in the triple buffer `tb` if
+it has not yet been fetched, `nothing` otherwise.
+
+See [`ShmTripleBuffer`](@ref) for details.
+
+"""
+function tryfetch(tb::ShmTripleBuffer)
+    base = pointer(tb)
+    state = _tribuf_state(base)
+    (_atomic_load(state, :monotonic) & _TRIBUF_DIRTY) == 0 && return nothing
+    front = _tribuf_front(base)
+    old = _atomic_xchg!(state, _atomic_load(front, :monotonic),
+                        :acquire_release)
+    _atomic_store!(front, old & 3, :monotonic)
+    return tb.bufs[(old & 3) + 1]
+end
+
+function Base.fetch(tb::ShmTripleBuffer)
+    A = tryfetch(tb)
+    A === nothing || return A
+    i = _atomic_load(_tribuf_front(pointer(tb)), :monotonic)
+    return tb.bufs[(i & 3) + 1]
+end
+
+# Layout of a triple buffer.  The header stores the magic number, the size of
+# the elements, the number of dimensions and the dimensions and, each on its
+# own cache line, the state (the index of the buffer with the latest version
+# and a bit set if this version has not yet been fetched), the index of the
+# buffer owned by the producer and the index of the buffer owned by the
+# consumer.  The header is followed by the three buffers.
+const _TRIBUF_MAGIC = 0x4655425254435049 # "IPCTRBUF" in little endian order
+const _TRIBUF_DIRTY = UInt64(4)
+const _TRIBUF_STATE_OFFSET = 64
+const _TRIBUF_BACK_OFFSET = 128
+const _TRIBUF_FRONT_OFFSET = 192
+const _TRIBUF_DATA_OFFSET = 256
+
+@inline _tribuf_state(base::Ptr) = Ptr{UInt64}(base + _TRIBUF_STATE_OFFSET)
+@inline _tribuf_back(base::Ptr) = Ptr{UInt64}(base + _TRIBUF_BACK_OFFSET)
+@inline _tribuf_front(base::Ptr) = Ptr{UInt64}(base + _TRIBUF_FRONT_OFFSET)
+
+_tribuf_stride(::Type{T}, dims::Tuple{Vararg{Integer}}) where {T} =
+    roundup(sizeof(T)*prod(dims; init=1), 64)
+
+# Build a triple buffer instance with the arrays wrapped once for all.
+function _tribuf(::Type{T}, mem::M, off::Int,
+                 dims::NTuple{N,Int}) where {T,N,M}
+    stride = _tribuf_stride(T, dims)
+    bufs = ntuple(i -> WrappedArray(mem, T, dims;
+                                    offset = (off + _TRIBUF_DATA_OFFSET +
+                                              (i - 1)*stride)), 3)
+    return ShmTripleBuffer{T,N,M}(mem, off, bufs)
+end
@@ -74,6 +74,12 @@ struct ShmId
     ShmId(value::Integer) = new(value)
 end
 
+# Identifier of a regular file used to back shared memory.
+struct File
+    path::String
+    File(path::AbstractString) = new(path)
+end
+
 mutable struct ShmInfo
     atime::UInt64 # last attach time
     dtime::UInt64 # last detach time
@@ -122,19 +128,74 @@ mutable struct DynamicMemory <: MemoryBlock
     end
 end
 
-mutable struct SharedMemory{T<:Union{String,ShmId}} <: MemoryBlock
+mutable struct SharedMemory{T<:Union{String,ShmId,FileDescriptor,File}} <: MemoryBlock
     ptr::Ptr{Cvoid} # mapped address of shared memory segment
     len::Int        # size of shared memory segment (in bytes)
     volatile::Bool  # true if shared memory is volatile (only for the creator)
     id::T           # identifier of shared memory segment
+    pagesize::Int   # size of memory pages backing the segment (in bytes)
+    gen::Int        # last known generation if growable, -1 otherwise
     function SharedMemory{T}(ptr::Ptr{Cvoid},
                              len::Integer,
                              volatile::Bool,
-                             id::T) where {T<:Union{String,ShmId}}
-        return finalizer(_destroy, new(ptr, len, volatile, id))
+                             id::T,
+                             pagesize::Integer = PAGE_SIZE,
+                             gen::Integer = -1) where {T<:Union{String,ShmId,FileDescriptor,File}}
+        return finalizer(_destroy, new(ptr, len, volatile, id, pagesize, gen))
     end
 end
 
+struct ShmArena{M}
+    mem::M    # memory object storing the arena
+    off::Int  # offset (in bytes) of the arena in the memory object
+end
+
+struct ShmPool{M}
+    mem::M         # memory object storing the pool
+    off::Int       # offset (in bytes) of the pool in the memory object
+    slotsize::Int  # size (in bytes) of the slots
+    nslots::Int    # number of slots
+    stride::Int    # distance (in bytes) between successive slots
+    data::Int      # offset (in bytes) of the first slot relative to the pool
+end
+
+# Ring buffers are mutable to store the last known index of the other side.
+mutable struct ShmRing{T,M}
+    mem::M        # memory object storing the ring
+    off::Int      # offset (in bytes) of the ring in the memory object
+    cap::Int      # capacity of the ring (a power of 2)
+    head::UInt64  # last known index of the consumer (used by the producer)
+    tail::UInt64  # last known index of the producer (used by the consumer)
+end
+
+struct ShmQueue{T,M}
+    mem::M    # memory object storing the queue
+    off::Int  # offset (in bytes) of the queue in the memory object
+    cap::Int  # capacity of the queue (a power of 2)
+end
+
+# Broadcast rings are mutable to store the cursor of the reader.
+mutable struct ShmBroadcast{M}
+    mem::M         # memory object storing the ring
+    off::Int       # offset (in bytes) of the ring in the memory object
+    slotsize::Int  # size (in bytes) of the slots
+    nslots::Int    # number of slots (a power of 2)
+    next::UInt64   # number of the next frame to read (only for readers)
+    dropped::Int   # number of frames missed by the reader
+end
+
+struct ShmSeqLock{T,N,M}
+    mem::M                # memory object storing the sequence lock
+    off::Int              # offset (in bytes) of the lock in the memory object
+    dims::NTuple{N,Int}   # dimensions of the protected data
+end
+
+struct ShmPtr{T}
+    off::Int  # offset (in bytes) relative to the memory object, 0 if null
+    ShmPtr{T}(off::Integer) where {T} = new{T}(off)
+    ShmPtr{T}() where {T} = new{T}(0)
+end
+
 struct WrappedArray{T,N,M} <: DenseArray{T,N}
     # All members shall be considered as private.
     arr::Array{T,N}  # wrapped Julia array
@@ -154,6 +215,12 @@ const ShmArray{T,N,M<:SharedMemory} = WrappedArray{T,N,M}
 const ShmVector{T,M} = ShmArray{T,1,M}
 const ShmMatrix{T,M} = ShmArray{T,2,M}
 
+struct ShmTripleBuffer{T,N,M}
+    mem::M                               # memory object storing the buffers
+    off::Int                             # offset (in bytes) of the buffers
+    bufs::NTuple{3,WrappedArray{T,N,M}}  # the three buffers
+end
+
 # Header for saving a minimal description of a wrapped array.  The layout is:
 #
 #   Name   Size
@@ -180,3 +247,14 @@ mutable struct Semaphore{T}
     # Provide inner constructor to force fully qualified calls.
     Semaphore{T}(ptr::Ptr, lnk) where {T} = new{T}(ptr, lnk)
 end
+
+mutable struct SemaphoreSet
+    id::Cint        # identifier of the System V semaphore set, -1 if removed
+    nsems::Int      # number of semaphores in the set
+    SemaphoreSet(id::Cint, nsems::Int) = new(id, nsems)
+end
+
+struct EventSemaphore
+    fd::FileDescriptor # event file descriptor
+    EventSemaphore(fd::FileDescriptor) = new(fd)
+end
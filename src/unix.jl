@@ -12,6 +12,83 @@
 # (https://github.com/emmt/InterProcessCommunication.jl).
 #
 
+"""
+```julia
+@gcsafe ccall(func, rettype, (argtypes...,), args...)
+```
+
+performs the call to the C function `func` in a GC-safe region, that is
+letting the garbage collector run in other threads while the call is in
+progress.  This must be used for calls which may block (waiting on a
+semaphore, a mutex, a signal, etc.) as otherwise a garbage collection
+triggered by any other thread would be stalled until the call returns.
+
+The arguments are converted (which may allocate memory) and preserved from
+being garbage collected before entering the GC-safe region, the called
+function shall not call Julia code.  The value of `errno` set by the call is
+preserved.
+
+The functions to enter and leave a GC-safe region are only exported by Julia
+1.9 and later, with earlier versions the call is performed as a plain `ccall`
+(see `IPC._GC_SAFE_CALLS`).
+
+"""
+macro gcsafe(ex)
+    (ex isa Expr && ex.head === :call && ex.args[1] === :ccall &&
+     length(ex.args) ≥ 4) || error("expecting a `ccall` expression")
+    func, rtype, argtypes = ex.args[2], ex.args[3], ex.args[4]
+    args = ex.args[5:end]
+    (argtypes isa Expr && argtypes.head === :tuple &&
+     length(argtypes.args) == length(args)) ||
+         error("argument types must be a tuple matching the arguments")
+    types = argtypes.args
+    cvars = [gensym("c") for i in eachindex(args)]
+    pvars = [gensym("p") for i in eachindex(args)]
+    # Converted arguments are passed to `ccall` as pointers, not references.
+    ptypes = map(types) do T
+        (T isa Expr && T.head === :curly && T.args[1] === :Ref) ?
+            Expr(:curly, :Ptr, T.args[2:end]...) : T
+    end
+    cconv = [:($(cvars[i]) = Base.cconvert($(esc(types[i])), $(esc(args[i]))))
+             for i in eachindex(args)]
+    pconv = [:($(pvars[i]) = Base.unsafe_convert($(esc(types[i])), $(cvars[i])))
+             for i in eachindex(args)]
+    call = Expr(:call, :ccall, esc(func), esc(rtype),
+                Expr(:tuple, map(esc, ptypes)...), pvars...)
+    _GC_SAFE_CALLS || return quote
+        $(cconv...)
+        GC.@preserve $(cvars...) begin
+            $(pconv...)
+            $call
+        end
+    end
+    return quote
+        $(cconv...)
+        GC.@preserve $(cvars...) begin
+            $(pconv...)
+            state = ccall(:jl_gc_safe_enter, Int8, ())
+            result = $call
+            errno = Libc.errno()
+            ccall(:jl_gc_safe_leave, Cvoid, (Int8,), state)
+            Libc.errno(errno)
+            result
+        end
+    end
+end
+
+"""
+```julia
+IPC._GC_SAFE_CALLS
+```
+
+is true if blocking calls wrapped by `IPC.@gcsafe` let the garbage collector
+run in other threads.  Before Julia 1.9, `jl_gc_safe_enter` and
+`jl_gc_safe_leave` are macros taking the thread local state and not exported
+functions.
+
+"""
+const _GC_SAFE_CALLS = VERSION ≥ v"1.9"
+
 """
 ```julia
 IPC.getpid() -> pid
@@ -112,6 +189,9 @@ _write(fd::Integer, buf::Union{DenseArray,Ptr}, cnt::Integer) =
 _lseek(fd::Integer, off::Integer, whence::Integer) =
     ccall(:lseek, _typeof_off_t, (Cint, _typeof_off_t, Cint), fd, off, whence)
 
+_unlink(path::AbstractString) =
+    ccall(:unlink, Cint, (Cstring,), path)
+
 _truncate(path::AbstractString, len::Integer) =
     ccall(:truncate, Cint, (Cstring, _typeof_off_t), path, len)
 
@@ -146,15 +226,91 @@ _mprotect(addr::Ptr, len::Integer, prot::Integer) =
 _msync(addr::Ptr, len::Integer, flags::Integer) =
     ccall(:msync, Cint, (Ptr{Cvoid}, _typeof_size_t, Cint), addr, len, flags)
 
+_madvise(addr::Ptr, len::Integer, advice::Integer) =
+    ccall(:madvise, Cint, (Ptr{Cvoid}, _typeof_size_t, Cint), addr, len, advice)
+
+_mlock(addr::Ptr, len::Integer) =
+    ccall(:mlock, Cint, (Ptr{Cvoid}, _typeof_size_t), addr, len)
+
+_munlock(addr::Ptr, len::Integer) =
+    ccall(:munlock, Cint, (Ptr{Cvoid}, _typeof_size_t), addr, len)
+
+# The `mremap` function is variadic, the optional 5th argument (the new address)
+# is not needed here.
+_mremap(addr::Ptr, oldlen::Integer, newlen::Integer, flags::Integer) =
+    ccall(:mremap, Ptr{Cvoid}, (Ptr{Cvoid}, _typeof_size_t, _typeof_size_t, Cint),
+          addr, oldlen, newlen, flags)
+
 _munmap(addr::Ptr, len::Integer) =
     ccall(:munmap, Cint, (Ptr{Cvoid}, _typeof_size_t), addr, len)
 
+# The `syscall` function is variadic, but all arguments are integers or
+# pointers which are passed in the same registers as for a non-variadic
+# function.
+@static if isdefined(@__MODULE__, :SYS_mbind)
+    _mbind(addr::Ptr, len::Integer, mode::Integer, mask::Ptr{Culong},
+           maxnode::Integer, flags::Integer) =
+               ccall(:syscall, Clong,
+                     (Clong, Ptr{Cvoid}, Culong, Cint, Ptr{Culong}, Culong, Cuint),
+                     SYS_mbind, addr, len, mode, mask, maxnode, flags)
+
+    _move_pages(pid::Integer, cnt::Integer, pages::Ptr{Ptr{Cvoid}},
+                nodes::Ptr{Cint}, status::Ptr{Cint}, flags::Integer) =
+                    ccall(:syscall, Clong,
+                          (Clong, Cint, Culong, Ptr{Ptr{Cvoid}}, Ptr{Cint},
+                           Ptr{Cint}, Cint),
+                          SYS_move_pages, pid, cnt, pages, nodes, status, flags)
+else
+    _mbind(addr::Ptr, len::Integer, mode::Integer, mask::Ptr{Culong},
+           maxnode::Integer, flags::Integer) =
+               (Libc.errno(Libc.ENOSYS); Clong(-1))
+
+    _move_pages(pid::Integer, cnt::Integer, pages::Ptr{Ptr{Cvoid}},
+                nodes::Ptr{Cint}, status::Ptr{Cint}, flags::Integer) =
+                    (Libc.errno(Libc.ENOSYS); Clong(-1))
+end
+
+@static if isdefined(@__MODULE__, :SYS_memfd_create)
+    _memfd_create(name::AbstractString, flags::Integer) =
+        Cint(ccall(:syscall, Clong, (Clong, Cstring, Cuint),
+                   SYS_memfd_create, name, flags))
+else
+    _memfd_create(name::AbstractString, flags::Integer) =
+        (Libc.errno(Libc.ENOSYS); Cint(-1))
+end
+
+@static if isdefined(@__MODULE__, :SYS_futex)
+    _futex(addr::Ptr{UInt32}, op::Integer, val::Integer,
+           timeout::Union{Ptr{TimeSpec},Ref{TimeSpec}}) =
+               @gcsafe ccall(:syscall, Clong,
+                             (Clong, Ptr{UInt32}, Cint, UInt32, Ptr{TimeSpec}),
+                             SYS_futex, addr, op, val, timeout)
+else
+    _futex(addr::Ptr{UInt32}, op::Integer, val::Integer,
+           timeout::Union{Ptr{TimeSpec},Ref{TimeSpec}}) =
+               (Libc.errno(Libc.ENOSYS); Clong(-1))
+end
+
 _shm_open(path::AbstractString, flags::Integer, mode::Integer) =
     ccall(:shm_open, Cint, (Cstring, Cint, _typeof_mode_t), path, flags, mode)
 
 _shm_unlink(path::AbstractString) =
     ccall(:shm_unlink, Cint, (Cstring,), path)
 
+_dup(fd::Integer) =
+    ccall(:dup, Cint, (Cint,), fd)
+
+_socketpair(domain::Integer, type::Integer, protocol::Integer,
+            fds::Union{DenseVector{Cint},Ptr{Cint}}) =
+    ccall(:socketpair, Cint, (Cint, Cint, Cint, Ptr{Cint}),
+          domain, type, protocol, fds)
+
+_sendmsg(fd::Integer, msg::Ptr, flags::Integer) =
+    ccall(:sendmsg, _typeof_ssize_t, (Cint, Ptr{Cvoid}, Cint), fd, msg, flags)
+
+_recvmsg(fd::Integer, msg::Ptr, flags::Integer) =
+    ccall(:recvmsg, _typeof_ssize_t, (Cint, Ptr{Cvoid}, Cint), fd, msg, flags)
+
 _sem_open(path::AbstractString, flags::Integer, mode::Integer, value::Unsigned) =
     ccall(:sem_open, Ptr{Cvoid}, (Cstring, Cint, _typeof_mode_t, Cuint),
           path, flags, mode, value)
@@ -172,13 +328,14 @@ _sem_post(sem::Ptr{Cvoid}) =
     ccall(:sem_post, Cint, (Ptr{Cvoid},), sem)
 
 _sem_wait(sem::Ptr{Cvoid}) =
-    ccall(:sem_wait, Cint, (Ptr{Cvoid},), sem)
+    @gcsafe ccall(:sem_wait, Cint, (Ptr{Cvoid},), sem)
 
 _sem_trywait(sem::Ptr{Cvoid}) =
     ccall(:sem_trywait, Cint, (Ptr{Cvoid},), sem)
 
 _sem_timedwait(sem::Ptr{Cvoid}, timeout::Union{Ref{TimeSpec},Ptr{TimeSpec}}) =
-    ccall(:sem_timedwait, Cint, (Ptr{Cvoid}, Ptr{TimeSpec}), sem, timeout)
+    @gcsafe ccall(:sem_timedwait, Cint, (Ptr{Cvoid}, Ptr{TimeSpec}),
+                  sem, timeout)
 
 _sem_init(sem::Ptr{Cvoid}, shared::Bool, value::Unsigned) =
     ccall(:sem_init, Cint, (Ptr{Cvoid}, Cint, Cuint),
@@ -187,6 +344,75 @@ _sem_init(sem::Ptr{Cvoid}, shared::Bool, value::Unsigned) =
 _sem_destroy(sem::Ptr{Cvoid}) =
     ccall(:sem_destroy, Cint, (Ptr{Cvoid},), sem)
 
+# Create an event file descriptor with semaphore semantics and non-blocking
+# operations.
+@static if isdefined(@__MODULE__, :EFD_SEMAPHORE)
+    _eventfd_semaphore(value::Integer) =
+        ccall(:eventfd, Cint, (Cuint, Cint),
+              value, EFD_SEMAPHORE|EFD_NONBLOCK|EFD_CLOEXEC)
+else
+    _eventfd_semaphore(value::Integer) = (Libc.errno(Libc.ENOSYS); Cint(-1))
+end
+
+@static if isdefined(@__MODULE__, :EPOLLIN)
+    _epoll_create1(flags::Integer) =
+        ccall(:epoll_create1, Cint, (Cint,), flags)
+
+    _epoll_ctl(epfd::Integer, op::Integer, fd::Integer,
+               event::DenseVector{UInt8}) =
+                   ccall(:epoll_ctl, Cint, (Cint, Cint, Cint, Ptr{UInt8}),
+                         epfd, op, fd, event)
+else
+    _epoll_create1(flags::Integer) = (Libc.errno(Libc.ENOSYS); Cint(-1))
+
+    _epoll_ctl(epfd::Integer, op::Integer, fd::Integer,
+               event::DenseVector{UInt8}) =
+                   (Libc.errno(Libc.ENOSYS); Cint(-1))
+end
+
+# Wait on several futexes (Linux 5.16 or more recent), `timeout` is an
+# absolute time given by the clock `clk`.
+@static if isdefined(@__MODULE__, :SYS_futex_waitv)
+    _futex_waitv(waiters::DenseVector{UInt8}, nr::Integer,
+                 timeout::Union{Ptr{TimeSpec},Ref{TimeSpec}}, clk::Integer) =
+                     @gcsafe ccall(:syscall, Clong,
+                                   (Clong, Ptr{UInt8}, Cuint, Cuint,
+                                    Ptr{TimeSpec}, _typeof_clockid_t),
+                                   SYS_futex_waitv, waiters, nr, 0,
+                                   timeout, clk)
+else
+    _futex_waitv(waiters::DenseVector{UInt8}, nr::Integer,
+                 timeout::Union{Ptr{TimeSpec},Ref{TimeSpec}}, clk::Integer) =
+                     (Libc.errno(Libc.ENOSYS); Clong(-1))
+end
+
+_semget(key::Integer, nsems::Integer, flg::Integer) =
+    ccall(:semget, Cint, (_typeof_key_t, Cint, Cint), key, nsems, flg)
+
+# The `semctl` function is variadic, its optional argument is either an
+# integer or a pointer.
+_semctl(id::Integer, num::Integer, cmd::Integer, arg::Union{DenseArray,Ptr}) =
+    ccall(:semctl, Cint, (Cint, Cint, Cint, Ptr{Cvoid}...),
+          id, num, cmd, arg)
+
+_semctl(id::Integer, num::Integer, cmd::Integer, val::Cint) =
+    ccall(:semctl, Cint, (Cint, Cint, Cint, Cint...), id, num, cmd, val)
+
+_semop(id::Integer, ops::DenseVector{UInt8}, nops::Integer) =
+    @gcsafe ccall(:semop, Cint, (Cint, Ptr{UInt8}, Csize_t), id, ops, nops)
+
+@static if Sys.islinux()
+    _semtimedop(id::Integer, ops::DenseVector{UInt8}, nops::Integer,
+                timeout::Ref{TimeSpec}) =
+                    @gcsafe ccall(:semtimedop, Cint,
+                                  (Cint, Ptr{UInt8}, Csize_t, Ptr{TimeSpec}),
+                                  id, ops, nops, timeout)
+else
+    _semtimedop(id::Integer, ops::DenseVector{UInt8}, nops::Integer,
+                timeout::Ref{TimeSpec}) =
+                    (Libc.errno(Libc.ENOSYS); Cint(-1))
+end
+
 #------------------------------------------------------------------------------
 # FILE DESCRIPTOR
 
@@ -271,3 +497,123 @@ function Base.skip(obj::FileDescriptor, offset::Integer)
 end
 
 Base.isopen(obj::FileDescriptor) = fd(obj) ≥ 0
+
+"""
+```julia
+IPC.sendfd(sock, obj)
+```
+
+sends a duplicate of the file descriptor associated with `obj` to the process
+at the other end of the connected Unix domain socket `sock`.  Argument `obj`
+can be a `FileDescriptor`, an integer file descriptor or a shared memory object
+created by `SharedMemory(FileDescriptor, len)`.  Argument `sock` can be a
+`FileDescriptor` or an integer file descriptor.
+
+```julia
+IPC.recvfd(sock) -> fd
+```
+
+receives a file descriptor sent by the process at the other end of the
+connected Unix domain socket `sock` and returns it as an instance of
+`FileDescriptor` which is automatically closed when garbage collected.  An
+`EOFError` is thrown if the other end has been closed.
+
+```julia
+IPC.socketpair() -> (fd1, fd2)
+```
+
+yields a pair of connected Unix domain sockets as two instances of
+`FileDescriptor`.  This is mostly useful for a parent process to communicate
+with its children.
+
+These methods are typically used to share anonymous memory (see
+[`SharedMemory`](@ref)) with unrelated processes:
+
+```julia
+shm = SharedMemory(FileDescriptor, len)  # in the sender
+IPC.sendfd(sock, shm)
+...
+shm = SharedMemory(IPC.recvfd(sock))     # in the receiver
+```
+
+"""
+function sendfd(sock, obj)
+    buf = _workspace(_FDMSG_SIZE)
+    GC.@preserve buf begin
+        msg, ctl = _fdmsg!(buf)
+        _poke!(_typeof_cmsg_len, ctl + _offsetof_cmsg_len, _sizeof_cmsg_len_fd)
+        _poke!(Cint, ctl + _offsetof_cmsg_level, SOL_SOCKET)
+        _poke!(Cint, ctl + _offsetof_cmsg_type, SCM_RIGHTS)
+        _poke!(Cint, ctl + _offsetof_cmsg_data, _fd(obj))
+        while _sendmsg(_fd(sock), msg, 0) == -1
+            errno = Libc.errno()
+            errno == Libc.EINTR || throw_system_error("sendmsg", errno)
+        end
+    end
+    nothing
+end
+
+function recvfd(sock)
+    buf = _workspace(_FDMSG_SIZE)
+    local fd::Cint
+    GC.@preserve buf begin
+        msg, ctl = _fdmsg!(buf)
+        while (cnt = _recvmsg(_fd(sock), msg, _msg_cmsg_cloexec_flag())) == -1
+            errno = Libc.errno()
+            errno == Libc.EINTR || throw_system_error("recvmsg", errno)
+        end
+        cnt == 0 && throw(EOFError())
+        if (_peek(_typeof_msg_controllen, msg + _offsetof_msg_controllen) <
+            _sizeof_cmsg_len_fd ||
+            _peek(Cint, ctl + _offsetof_cmsg_level) != SOL_SOCKET ||
+            _peek(Cint, ctl + _offsetof_cmsg_type) != SCM_RIGHTS)
+            throw_error_exception("no file descriptor has been received")
+        end
+        fd = _peek(Cint, ctl + _offsetof_cmsg_data)
+    end
+    return finalizer(_close, FileDescriptor(fd))
+end
+
+function socketpair()
+    fds = Cint[-1, -1]
+    systemerror("socketpair", _socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    return (finalizer(_close, FileDescriptor(fds[1])),
+            finalizer(_close, FileDescriptor(fds[2])))
+end
+
+@doc @doc(sendfd) recvfd
+@doc @doc(sendfd) socketpair
+
+_fd(obj::FileDescriptor) = fd(obj)
+_fd(fd::Integer) = convert(Cint, fd)
+_fd(shm::SharedMemory{FileDescriptor}) = fd(shmid(shm))
+
+# Size of the workspace for a message carrying a file descriptor: `struct
+# msghdr` followed by a single `struct iovec`, the control data and a single
+# byte of data (at least one byte of data must be sent).
+const _FDMSG_SIZE = (_sizeof_struct_msghdr + _sizeof_struct_iovec +
+                     _sizeof_cmsg_space_fd + 1)
+
+# Initialize a message to carry a file descriptor in workspace `buf` and yield
+# the addresses of the message and of its control data.
+function _fdmsg!(buf::Vector{UInt8})
+    fill!(buf, 0)
+    msg = pointer(buf)
+    iov = msg + _sizeof_struct_msghdr
+    ctl = iov + _sizeof_struct_iovec
+    dat = ctl + _sizeof_cmsg_space_fd
+    _poke!(Ptr{UInt8}, iov + _offsetof_iov_base, dat)
+    _poke!(_typeof_size_t, iov + _offsetof_iov_len, 1)
+    _poke!(Ptr{UInt8}, msg + _offsetof_msg_iov, iov)
+    _poke!(_typeof_msg_iovlen, msg + _offsetof_msg_iovlen, 1)
+    _poke!(Ptr{UInt8}, msg + _offsetof_msg_control, ctl)
+    _poke!(_typeof_msg_controllen, msg + _offsetof_msg_controllen,
+           _sizeof_cmsg_space_fd)
+    return msg, ctl
+end
+
+@static if isdefined(@__MODULE__, :MSG_CMSG_CLOEXEC)
+    _msg_cmsg_cloexec_flag() = MSG_CMSG_CLOEXEC
+else
+    _msg_cmsg_cloexec_flag() = zero(Cint)
+end
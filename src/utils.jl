@@ -134,7 +134,8 @@ nanosleep(t::Union{Real,TimeVal,Libc.TimeVal}) = nanosleep(TimeSpec(t))
 
 function nanosleep(ts::TimeSpec)
     rem = Ref(TimeSpec(0,0))
-    ccall(:nanosleep, Cint, (Ptr{TimeSpec}, Ptr{TimeSpec}), Ref(ts), rem)
+    @gcsafe ccall(:nanosleep, Cint, (Ptr{TimeSpec}, Ptr{TimeSpec}),
+                  Ref(ts), rem)
     return rem[]
 end
 
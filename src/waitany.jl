@@ -0,0 +1,146 @@
+#
+# waitany.jl --
+#
+# Waiting on any of several synchronization objects for Julia.
+#
+#------------------------------------------------------------------------------
+#
+# This file is part of InterProcessCommunication.jl released under the MIT
+# "expat" license.
+#
+# Copyright (C) 2016-2019, Éric Thiébaut
+# (https://github.com/emmt/InterProcessCommunication.jl).
+#
+
+"""
+```julia
+IPC.waitany(sems; timeout=Inf) -> i
+```
+
+waits until any of the event semaphores in the vector `sems` (see
+[`EventSemaphore`](@ref)) can be decremented, decrements it and yields its
+index `i`.  If several semaphores are available, the one with the smallest
+index is decremented.  The result is `0` if no semaphores became available
+within `timeout` seconds.
+
+The file descriptors of the semaphores are monitored by a single `epoll(7)`
+instance which is itself watched by the event loop of Julia: only the calling
+task is suspended while waiting and there is no busy polling.
+
+```julia
+IPC.waitany(words; timeout=Inf) -> i
+```
+
+waits on several 32-bit words in shared memory in the same way as
+[`IPC.futex_wait`](@ref) does for a single word.  Each entry of the vector
+`words` is a tuple `(mem, off, expected)` with `mem` a memory object, `off`
+the offset (in bytes) of the word in `mem` and `expected` its expected value.
+The calling thread is blocked while all the words have their expected values
+and until another thread or process calls [`IPC.futex_wake`](@ref) for any of
+them or until `timeout` seconds have elapsed.  The result is the index of the
+word which was woken up or whose value was not the expected one, or `0` if the
+time limit expired.  As with `IPC.futex_wait`, spurious wake-ups are possible,
+so the caller must check the value of the words.  At most 128 words can be
+waited on.  This requires the `futex_waitv` system call (Linux 5.16 or more
+recent), otherwise a `SystemError` is thrown with code `ENOSYS`.
+
+See also: [`EventSemaphore`](@ref), [`IPC.futex_wait`](@ref).
+
+"""
+function waitany(sems::AbstractVector{EventSemaphore}; timeout::Real = Inf)
+    length(sems) ≥ 1 || throw_argument_error("no semaphores to wait on")
+    (i = _trywaitany(sems)) > 0 && return i
+    timeout > 0 || return 0
+    epfd = _epoll_create1(EPOLL_CLOEXEC)
+    epfd == -1 && throw_system_error("epoll_create1")
+    try
+        evt = zeros(UInt8, _sizeof_struct_epoll_event)
+        _poke!(Cuint, evt, 0, EPOLLIN)
+        for sem in sems
+            systemerror("epoll_ctl",
+                        _epoll_ctl(epfd, EPOLL_CTL_ADD, fd(sem), evt) == -1)
+        end
+        # The epoll instance is readable as long as any of the semaphores is
+        # non-zero.  Another process may decrement the semaphore before us,
+        # hence the loop.
+        deadline = time() + timeout
+        while true
+            (i = _trywaitany(sems)) > 0 && return i
+            if isinf(timeout)
+                FileWatching.poll_fd(RawFD(epfd); readable = true)
+            else
+                remaining = deadline - time()
+                remaining > 0 || return 0
+                FileWatching.poll_fd(RawFD(epfd), remaining; readable = true)
+            end
+        end
+    finally
+        _close(epfd)
+    end
+end
+
+function waitany(words::AbstractVector{<:Tuple{Any,Integer,Integer}};
+                 timeout::Real = Inf)
+    n = length(words)
+    1 ≤ n ≤ _FUTEX_WAITV_MAX ||
+        throw_argument_error("invalid number of words to wait on (", n, ")")
+    buf = zeros(UInt8, n*_FUTEX_WAITV_SIZE)
+    GC.@preserve words buf begin
+        ptrs = Vector{Ptr{UInt32}}(undef, n)
+        vals = Vector{UInt32}(undef, n)
+        for (k, (mem, off, val)) in enumerate(words)
+            ptrs[k] = _atomic_pointer(mem, UInt32, off)
+            vals[k] = val % UInt32
+            base = (k - 1)*_FUTEX_WAITV_SIZE
+            _poke!(UInt64, buf, base,      vals[k])
+            _poke!(UInt64, buf, base + 8,  UInt64(ptrs[k]))
+            _poke!(UInt32, buf, base + 16, FUTEX2_SIZE_U32)
+        end
+        if isinf(timeout) && timeout > 0
+            ts = Ptr{TimeSpec}(C_NULL)
+        else
+            ts = Ref(clock_gettime(CLOCK_MONOTONIC) +
+                     max(Float64(timeout), 0.0))
+        end
+        while true
+            res = _futex_waitv(buf, n, ts, CLOCK_MONOTONIC)
+            res ≥ 0 && return Int(res) + 1
+            code = Libc.errno()
+            if code == Libc.EAGAIN
+                # Some word did not have its expected value.
+                for k in 1:n
+                    _atomic_load(ptrs[k], :acquire) == vals[k] || return k
+                end
+            elseif code == Libc.ETIMEDOUT
+                return 0
+            elseif code != Libc.EINTR
+                throw_system_error("futex_waitv", code)
+            end
+        end
+    end
+end
+
+# Attempt to decrement any of the semaphores, yielding the index of the
+# decremented one or 0.
+function _trywaitany(sems::AbstractVector{EventSemaphore})
+    for (k, sem) in enumerate(sems)
+        trywait(sem) && return k
+    end
+    return 0
+end
+
+# Maximum number of futexes and size of `struct futex_waitv`.
+const _FUTEX_WAITV_MAX = 128
+const _FUTEX_WAITV_SIZE = 24
+
+@static if !isdefined(@__MODULE__, :SYS_futex_waitv)
+    const FUTEX2_SIZE_U32 = Cuint(0x02)
+end
+
+@static if !isdefined(@__MODULE__, :EPOLLIN)
+    # Only used as arguments to `_epoll_*` which fail with `ENOSYS`.
+    const EPOLL_CLOEXEC = Cint(0)
+    const EPOLL_CTL_ADD = Cint(1)
+    const EPOLLIN = Cuint(0x0001)
+    const _sizeof_struct_epoll_event = 12
+end
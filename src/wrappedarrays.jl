@@ -64,12 +64,22 @@ WrappedArray(id, T, dims; perms=0o600, volatile=true)
 
 creates a new wrapped array whose elements (and a header) are stored in shared
 memory identified by `id` (see [`SharedMemory`](@ref) for a description of `id`
-and for keywords).  To retrieve this array in another process, just do:
+and for keywords, for instance keyword `numa` to specify the NUMA placement
+policy of the elements).  The NUMA placement policy of the memory backing any
+wrapped array `A` can also be set by [`IPC.mempolicy!(A, policy)`](@ref
+IPC.mempolicy!) and the NUMA nodes where live the elements of `A` can be
+queried by [`IPC.pagenodes(A)`](@ref IPC.pagenodes).  To retrieve this array
+in another process, just do:
 
 ```julia
 WrappedArray(id; readonly=false)
 ```
 
+If `id` is `FileDescriptor`, the array is stored in anonymous shared memory
+whose file descriptor, given by `shmid(A)`, can be sent to another process with
+[`IPC.sendfd`](@ref) and the array retrieved by the receiver with
+`WrappedArray(IPC.recvfd(sock))`.
+
 
 ## See Also
 
@@ -106,17 +116,20 @@ function WrappedArray(mem, dec::Function)
     return WrappedArray(mem, T, dims; offset = offset)
 end
 
-function WrappedArray(id::Union{AbstractString,ShmId,Key},
+function WrappedArray(id::Union{AbstractString,ShmId,Key,File,
+                                Type{FileDescriptor}},
                       ::Type{T}, dims::Vararg{Integer,N}; kwds...) where {T,N}
     return WrappedArray(id, T, convert(NTuple{N,Int}, dims); kwds...)
 end
 
-function WrappedArray(id::Union{AbstractString,ShmId,Key},
+function WrappedArray(id::Union{AbstractString,ShmId,Key,File,
+                                Type{FileDescriptor}},
                       ::Type{T}, dims::NTuple{N,Integer}; kwds...) where {T,N}
     return WrappedArray(id, T, convert(NTuple{N,Int}, dims); kwds...)
 end
 
-function WrappedArray(id::Union{AbstractString,ShmId,Key},
+function WrappedArray(id::Union{AbstractString,ShmId,Key,File,
+                                Type{FileDescriptor}},
                       ::Type{T}, dims::NTuple{N,Int};
                       kwds...) where {T,N}
     num = checkdims(dims)
@@ -127,7 +140,9 @@ function WrappedArray(id::Union{AbstractString,ShmId,Key},
     return WrappedArray(mem, T, dims; offset=off)
 end
 
-function WrappedArray(id::Union{AbstractString,ShmId,Key}; kwds...)
+function WrappedArray(id::Union{AbstractString,ShmId,Key,File,
+                                FileDescriptor};
+                      kwds...)
     mem = SharedMemory(id; kwds...)
     T, dims, off = read(mem, WrappedArrayHeader)
     return WrappedArray(mem, T, dims; offset=off)
@@ -313,6 +313,29 @@ end
             @test trywait(sem2) == true
             @test trywait(sem2) == false
             @test_throws TimeoutError timedwait(sem2, 0.1)
+            # Asynchronous waits do not block other tasks.
+            post(sem1)
+            wait(sem2; async=true)
+            @test sem2[] == 0
+            @test_throws TimeoutError timedwait(sem2, 0.1; async=true)
+            task = @async wait(sem2; async=true)
+            sleep(0.1)
+            @test !istaskdone(task)
+            post(sem1)
+            wait(task)
+            @test sem2[] == 0
+            task = @async timedwait(sem2, 10; async=true)
+            sleep(0.1)
+            post(sem1)
+            @test fetch(task) === nothing
+            # Pending asynchronous waits do not delay others.
+            other = Semaphore(DynamicMemory(sizeof(Semaphore)), 0)
+            idle = [@async wait(other; async=true) for i in 1:8]
+            sleep(0.1)
+            post(sem1)
+            @test timedwait(sem2, 10; async=true) === nothing
+            foreach(i -> post(other), idle)
+            foreach(wait, idle)
         end
         GC.gc() # call garbage collector to exercise the finalizers
     end
@@ -440,6 +463,914 @@ end
     GC.gc() # call garbage collector to exercise the finalizers
 end
 
+@testset "Huge Pages            " begin
+    begin
+        # Transparent huge pages cannot back a segment smaller than a huge
+        # page, the measured page size must not depend on system settings.
+        len = 3*IPC.PAGE_SIZE
+        name = "/shm-huge-$(getpid())"
+        rm(SharedMemory, name)
+        A = SharedMemory(name, len; hugepages=true, prefault=true)
+        @test sizeof(A) == len
+        @test IPC.pagesize(A) == IPC.PAGE_SIZE
+        B = SharedMemory(IPC.PRIVATE, len)
+        @test IPC.pagesize(B) == IPC.PAGE_SIZE
+        # Huge pages may not have been reserved on this system, in which case
+        # `SHM_HUGETLB` and `MFD_HUGETLB` fail and there is nothing to check.
+        for id in (IPC.PRIVATE, FileDescriptor)
+            C = try
+                SharedMemory(id, len; hugepages=true)
+            catch err
+                @test isa(err, SystemError) || isa(err, ErrorException)
+                nothing
+            end
+            if C !== nothing
+                @test IPC.pagesize(C) == IPC.hugepagesize()
+                @test sizeof(C) % IPC.hugepagesize() == 0
+            end
+        end
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Prefaulted Memory     " begin
+    begin
+        len = 3*IPC.PAGE_SIZE
+        name = "/shm-prefault-$(getpid())"
+        rm(SharedMemory, name)
+        A = SharedMemory(name, len; prefault=true)
+        B = SharedMemory(name; readonly=true, prefault=true)
+        C = SharedMemory(IPC.PRIVATE, len; prefault=true)
+        D = SharedMemory(shmid(C); readonly=true, prefault=true)
+        @test sizeof(A) == sizeof(B) == sizeof(C) == sizeof(D) == len
+        Aptr = convert(Ptr{UInt8}, pointer(A))
+        Bptr = convert(Ptr{UInt8}, pointer(B))
+        unsafe_store!(Aptr, 0x2a, len)
+        @test unsafe_load(Bptr, len) == 0x2a
+        # Locking may not be permitted (see `ulimit -l`).
+        for id in ("/shm-lock-$(getpid())", IPC.PRIVATE)
+            E = try
+                SharedMemory(id, len; lock=true)
+            catch err
+                @test isa(err, SystemError)
+                nothing
+            end
+            E === nothing || @test sizeof(E) == len
+        end
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "NUMA Placement        " begin
+    begin
+        nodes = IPC.numanodes()
+        @test length(nodes) ≥ 1
+        @test_throws ArgumentError IPC.MemPolicy(:nowhere)
+        @test_throws ArgumentError IPC.MemPolicy(maximum(nodes) + 1)
+        len = 4*IPC.PAGE_SIZE
+        name = "/shm-numa-$(getpid())"
+        rm(SharedMemory, name)
+        A = SharedMemory(name, len; numa=:interleave, prefault=true)
+        B = SharedMemory(IPC.PRIVATE, len; numa=first(nodes))
+        for obj in (A, B)
+            pages = IPC.pagenodes(obj)
+            @test length(pages) == 4
+            @test all(n -> n == -1 || n ∈ nodes, pages)
+        end
+        C = WrappedArray(IPC.PRIVATE, Float64, 100; numa=(:bind, nodes))
+        @test IPC.mempolicy!(C, :firsttouch) === C
+        fill!(C, 1)
+        @test all(n -> n ∈ nodes, IPC.pagenodes(C))
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Shared Memory (memfd) " begin
+    if Sys.islinux()
+        len = 2*IPC.PAGE_SIZE + 100
+        A = SharedMemory(FileDescriptor, len; name="anonymous")
+        @test sizeof(A) == len
+        @test isa(shmid(A), FileDescriptor)
+        @test IPC.pagesize(A) == IPC.PAGE_SIZE
+        a = WrappedArray(A, Int)
+        a[:] = 1:length(a)
+        s1, s2 = IPC.socketpair()
+        IPC.sendfd(s1, A) # send the shared memory object itself
+        fd = IPC.recvfd(s2)
+        @test isa(fd, FileDescriptor) && isopen(fd)
+        B = SharedMemory(fd)
+        close(fd) # the shared memory object owns its own file descriptor
+        @test sizeof(B) == sizeof(A)
+        @test pointer(B) != pointer(A)
+        b = WrappedArray(B, Int)
+        @test b == a
+        b[1] = -1
+        @test a[1] == -1
+        C = SharedMemory(shmid(A); readonly=true)
+        @test WrappedArray(C, Int) == b
+        rm(A) # no-op for anonymous shared memory
+        @test isopen(shmid(A))
+        D = WrappedArray(FileDescriptor, Float32, 3, 4)
+        D[:] = 1:length(D)
+        IPC.sendfd(s1, shmid(D))
+        E = WrappedArray(IPC.recvfd(s2))
+        @test eltype(E) === Float32 && size(E) == (3,4) && E == D
+        close(s1)
+        @test_throws EOFError IPC.recvfd(s2)
+        close(s2)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Growable Shared Memory" begin
+    if Sys.islinux()
+        name = "/shm-grow-$(getpid())"
+        rm(SharedMemory, name)
+        A = SharedMemory(name, 100; growable=true)
+        @test sizeof(A) == 100
+        unsafe_store!(Ptr{Int}(pointer(A)), 42)
+        B = SharedMemory(name; growable=true) # another view of the same memory
+        @test sizeof(B) == 100
+        @test pointer(B) != pointer(A)
+        @test unsafe_load(Ptr{Int}(pointer(B))) == 42
+        len = 3*IPC.PAGE_SIZE
+        @test resize!(A, len) === A
+        @test sizeof(A) == len
+        @test unsafe_load(Ptr{Int}(pointer(A))) == 42
+        @test sizeof(B) == len # B has been lazily remapped
+        unsafe_store!(Ptr{UInt8}(pointer(B)) + len - 1, 0x7f)
+        @test unsafe_load(Ptr{UInt8}(pointer(A)) + len - 1) == 0x7f
+        @test resize!(B, 50) === B
+        @test sizeof(A) == 50
+        @test unsafe_load(Ptr{Int}(pointer(A))) == 42
+        C = SharedMemory(FileDescriptor, 10; growable=true)
+        resize!(C, 5000)
+        D = SharedMemory(shmid(C); growable=true)
+        @test sizeof(D) == 5000
+        # Growability is not guessed from the contents of the memory.
+        @test sizeof(SharedMemory(name)) == 50 + IPC._SHM_HEADER_SIZE
+        E = SharedMemory(FileDescriptor, 100)
+        unsafe_store!(Ptr{UInt64}(pointer(E)), 0x574f52472d435049) # "IPC-GROW"
+        @test sizeof(SharedMemory(shmid(E))) == 100
+        @test_throws ArgumentError SharedMemory(shmid(E); growable=true)
+        @test_throws ArgumentError SharedMemory(
+            shmid(SharedMemory(FileDescriptor, 10)); growable=true)
+        @test_throws ArgumentError resize!(SharedMemory(FileDescriptor, 10), 20)
+        @test_throws ErrorException resize!(SharedMemory(IPC.PRIVATE, 10), 20)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Cache of Handles      " begin
+    begin
+        IPC.clearcache!()
+        @test IPC.cachestats() == (hits = 0, misses = 0)
+        name = "/shm-cache-$(getpid())"
+        rm(SharedMemory, name)
+        A = SharedMemory(name, 1000)
+        B = SharedMemory(name; cache=true)
+        C = SharedMemory(name; cache=true)
+        D = SharedMemory(name; cache=true, readonly=true)
+        E = SharedMemory(name)
+        @test B !== A && C === B && D !== B && E !== B
+        @test IPC.cachestats() == (hits = 1, misses = 2)
+        S = SharedMemory(IPC.PRIVATE, 1000; cache=true)
+        id = shmid(S)
+        @test SharedMemory(id; cache=true) === S
+        @test SharedMemory(id; cache=true) === S
+        @test IPC.cachestats() == (hits = 3, misses = 2)
+        semname = "/sem-cache-$(getpid())"
+        rm(Semaphore, semname)
+        sem = Semaphore(semname, 0; cache=true)
+        @test Semaphore(semname; cache=true) === sem
+        @test Semaphore(semname) !== sem
+        @test IPC.cachestats() == (hits = 4, misses = 2)
+        IPC.clearcache!()
+        @test SharedMemory(name; cache=true) !== B
+        @test IPC.cachestats() == (hits = 0, misses = 1)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "File-Backed Memory    " begin
+    mktempdir() do dir
+        path = joinpath(dir, "shm.dat")
+        len = 2*IPC.PAGE_SIZE + 10
+        A = SharedMemory(IPC.File(path), len)
+        @test isfile(path) && filesize(path) == len
+        @test sizeof(A) == len
+        @test shmid(A) == IPC.File(path)
+        @test_throws SystemError SharedMemory(IPC.File(path), len)
+        a = WrappedArray(A, UInt8)
+        a[:] = rand(UInt8, len)
+        @test flush(A) === nothing
+        @test flush(A; async=true) === nothing
+        @test flush(A, 3:IPC.PAGE_SIZE + 5) === nothing
+        @test flush(A, 1:0) === nothing
+        @test_throws ArgumentError flush(A, 0:1)
+        @test_throws ArgumentError flush(A, len:len+1)
+        B = SharedMemory(IPC.File(path); readonly=true)
+        @test WrappedArray(B, UInt8) == a
+        @test read(path) == a
+        @test_throws ErrorException resize!(A, 2len)
+        C = WrappedArray(IPC.File(joinpath(dir, "arr.dat")), Float64, 3, 4)
+        C[:] = 1:length(C)
+        flush(C)
+        D = WrappedArray(IPC.File(joinpath(dir, "arr.dat")); prefault=true)
+        @test eltype(D) === Float64 && size(D) == (3,4) && D == C
+        E = SharedMemory(IPC.File(joinpath(dir, "tmp.dat")), 100; volatile=true)
+        @test isfile(joinpath(dir, "tmp.dat"))
+        rm(SharedMemory, IPC.File(path)) # mappings remain valid
+        @test !isfile(path)
+        @test WrappedArray(B, UInt8) == a
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Shared Memory Arena   " begin
+    begin
+        mem = SharedMemory(IPC.PRIVATE, 1 << 16)
+        arena = ShmArena(mem, 1 << 15; offset=64)
+        @test sizeof(arena) == 1 << 15
+        @test_throws ArgumentError ShmArena(mem; offset=128)
+        @test_throws ArgumentError ShmArena(mem, 1024; offset=8)
+        sizes = [0, 1, 15, 16, 17, 100, 1000, 4000]
+        offs = [IPC.alloc!(arena, n) for n in sizes]
+        @test all(off -> off % 16 == 0, offs)
+        for i in 1:length(offs), j in i+1:length(offs)
+            @test offs[i] + sizes[i] ≤ offs[j] || offs[j] + sizes[j] ≤ offs[i]
+        end
+        A = WrappedArray(mem, UInt8, 1000; offset=offs[7])
+        fill!(A, 0x5a)
+        other = ShmArena(mem; offset=64) # as attached by another process
+        @test pointer(other, offs[7]) == pointer(A)
+        IPC.free!(other, offs[7])
+        @test_throws ArgumentError IPC.free!(arena, offs[7])
+        @test_throws ArgumentError IPC.free!(arena, 3)
+        @test IPC.alloc!(arena, 900) == offs[7] # recycled block
+        @test_throws OutOfMemoryError IPC.alloc!(arena, 1 << 15)
+        n = 0
+        try
+            while true
+                IPC.alloc!(arena, 100)
+                n += 1
+            end
+        catch err
+            @test isa(err, OutOfMemoryError)
+        end
+        @test n > 0
+        # Concurrent allocations and releases.
+        arena = ShmArena(mem, 1 << 15; offset=1 << 15)
+        offs = zeros(Int, 200)
+        Threads.@threads for i in 1:length(offs)
+            off = IPC.alloc!(arena, 64)
+            IPC.free!(arena, off)
+            offs[i] = IPC.alloc!(arena, 64)
+        end
+        @test allunique(offs)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Shared Memory Pool    " begin
+    begin
+        @test sizeof(ShmPool, 100, 10) == 128*10 + 192
+        mem = SharedMemory(IPC.PRIVATE, 1 << 16)
+        pool = ShmPool(mem, 100, 10; offset=64)
+        @test length(pool) == 10
+        @test_throws ArgumentError ShmPool(mem; offset=128)
+        @test_throws ArgumentError ShmPool(mem, 100, 10; offset=8)
+        @test_throws ArgumentError ShmPool(mem, 1 << 16, 10)
+        idx = [IPC.acquire!(pool) for i in 1:10]
+        @test sort(idx) == 1:10
+        @test IPC.acquire!(pool) == 0 # exhausted pool
+        @test all(i -> convert(Int, pointer(pool, i)) % 64 == 0, idx)
+        A = pool[idx[3]]
+        @test isa(A, WrappedArray{UInt8,1})
+        @test length(A) == 100
+        @test pointer(A) == pointer(pool, idx[3])
+        fill!(A, 0x5a)
+        other = ShmPool(mem; offset=64) # as attached by another process
+        @test length(other) == 10
+        @test all(isequal(0x5a), other[idx[3]])
+        IPC.release!(other, idx[3])
+        @test_throws ArgumentError IPC.release!(pool, idx[3])
+        @test_throws ArgumentError IPC.release!(pool, 11)
+        @test_throws ArgumentError pool[0]
+        @test IPC.acquire!(pool) == idx[3] # recycled slot
+        foreach(i -> IPC.release!(pool, i), idx)
+        # Concurrent acquisitions and releases.
+        pool = ShmPool(mem, 64, 200; offset=1 << 15)
+        idx = zeros(Int, 200)
+        Threads.@threads for i in 1:length(idx)
+            j = IPC.acquire!(pool)
+            IPC.release!(pool, j)
+            idx[i] = IPC.acquire!(pool)
+        end
+        @test sort(idx) == 1:200
+        # Pool directly stored in shared memory.
+        pool = ShmPool(IPC.PRIVATE, 16, 4)
+        @test isa(pool.mem, SharedMemory)
+        @test sizeof(pool.mem) ≥ sizeof(ShmPool, 16, 4)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+# Node of a linked list stored in shared memory.
+struct ListNode
+    val::Int
+    next::ShmPtr{ListNode}
+end
+
+@testset "Relative Pointers     " begin
+    begin
+        @test isbitstype(ShmPtr{ListNode})
+        @test sizeof(ShmPtr{ListNode}) == sizeof(Ptr{Cvoid})
+        @test IPC.isnull(ShmPtr{Int}())
+        @test !IPC.isnull(ShmPtr{Int}(8))
+        @test Int(ShmPtr{Int}(8) + 16) == 24
+        @test Int(ShmPtr{Int}(8) - 8) == 0
+        @test ShmPtr{UInt8}(ShmPtr{Int}(8)) === ShmPtr{UInt8}(8)
+        mem = SharedMemory(IPC.PRIVATE, 1 << 14)
+        arena = ShmArena(mem, 1 << 13)
+        @test pointer(mem, ShmPtr{Int}()) == Ptr{Int}(0)
+        # Build a linked list in shared memory.
+        head = ShmPtr{ListNode}()
+        for val in 1:10
+            p = ShmPtr{ListNode}(IPC.alloc!(arena, sizeof(ListNode)))
+            unsafe_store!(mem, p, ListNode(val, head))
+            head = p
+        end
+        p = ShmPtr{ListNode}(mem, pointer(mem, head))
+        @test p === head
+        @test ShmPtr{ListNode}(mem, Ptr{ListNode}(0)) === ShmPtr{ListNode}()
+        vals = Int[]
+        while !IPC.isnull(p)
+            node = unsafe_load(mem, p)
+            push!(vals, node.val)
+            p = node.next
+        end
+        @test vals == 10:-1:1
+        # Resolution against a wrapped array.
+        A = WrappedArray(mem, Int, 16; offset=1 << 13)
+        p = ShmPtr{Int}(3*sizeof(Int))
+        unsafe_store!(A, p, 42)
+        @test A[4] == 42
+        @test unsafe_load(A, p, 2) == A[5]
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Fixed-Address Mapping " begin
+    if Sys.islinux()
+        len = 3*Int(IPC.PAGE_SIZE)
+        name = "/ipc-fixed-$(getpid())"
+        shm1 = SharedMemory(name, len; volatile=false)
+        addr = pointer(shm1)
+        # The address is in use.
+        @test_throws SystemError SharedMemory(name; address=addr)
+        @test_throws SystemError SharedMemory(IPC.PRIVATE, len; address=addr)
+        @test_throws SystemError SharedMemory(FileDescriptor, len;
+                                              address=addr)
+        @test_throws ArgumentError SharedMemory(name; address=addr + 1)
+        @test_throws ArgumentError SharedMemory(name; address=0)
+        @test_throws ArgumentError SharedMemory(name*"-grow", len;
+                                                growable=true, address=addr)
+        # Unmap, then map again at the same address.
+        finalize(shm1)
+        shm2 = SharedMemory(name; address=addr)
+        @test pointer(shm2) == addr
+        @test sizeof(shm2) == len
+        unsafe_store!(Ptr{Int}(pointer(shm2)), 42)
+        finalize(shm2)
+        shm3 = SharedMemory(IPC.PRIVATE, len; address=UInt(addr))
+        @test pointer(shm3) == addr
+        finalize(shm3)
+        shm4 = SharedMemory(name; readonly=true, address=addr)
+        @test pointer(shm4) == addr
+        @test unsafe_load(Ptr{Int}(pointer(shm4))) == 42
+        rm(SharedMemory, name)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Memory Advices        " begin
+    begin
+        len = 4*Int(IPC.PAGE_SIZE)
+        shm = SharedMemory(IPC.PRIVATE, len)
+        for adv in (:sequential, :random, :willneed, :normal)
+            @test IPC.advise!(shm, adv) === shm
+            @test IPC.advise!(shm, 100:len-100, adv) === shm
+        end
+        @test_throws ArgumentError IPC.advise!(shm, :nonsense)
+        @test_throws ArgumentError IPC.advise!(shm, 0:10, :normal)
+        @test_throws ArgumentError IPC.advise!(shm, 1:len+1, :normal)
+        @test IPC.advise!(shm, 2:1, :normal) === shm
+        A = WrappedArray(shm, Int, div(len, sizeof(Int)))
+        fill!(A, 7)
+        # Shared memory contents is preserved.
+        @test IPC.advise!(A, 10:div(length(A), 2), :dontneed) === A
+        @test all(isequal(7), A)
+        @test IPC.advise!(A, :dontneed) === A
+        @test all(isequal(7), A)
+        # Bytes of private memory outside the range are preserved.
+        n = div(3*len, sizeof(Int))
+        B = WrappedArray(DynamicMemory(3*len), Int, n)
+        fill!(B, 7)
+        @test IPC.advise!(B, 10:n-10, :dontneed) === B
+        @test all(isequal(7), B[1:9]) && all(isequal(7), B[n-9:n])
+        fill!(B, 7)
+        @test IPC.advise!(B, 10:11, :dontneed) === B # no whole pages
+        @test all(isequal(7), B[1:20])
+        @test_throws BoundsError IPC.advise!(A, 0:2, :willneed)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Shared Memory Ring    " begin
+    begin
+        @test sizeof(ShmRing{Int}, 8) == 192 + 8*8
+        mem = SharedMemory(IPC.PRIVATE, 1 << 14)
+        @test_throws ArgumentError ShmRing{Int}(mem, 6)
+        @test_throws ArgumentError ShmRing{Vector{Int}}(mem, 8)
+        @test_throws ArgumentError ShmRing{Int}(mem, 8; offset=8)
+        @test_throws ArgumentError ShmRing{Int}(mem; offset=1024)
+        ring = ShmRing{Int}(mem, 8; offset=64)
+        @test eltype(ring) === Int
+        @test IPC.capacity(ring) == 8
+        @test isempty(ring) && !IPC.isfull(ring)
+        @test IPC.trypop!(ring) === nothing
+        @test IPC.trypush!(ring, 1) == true
+        @test push!(ring, 2) === ring
+        @test length(ring) == 2
+        other = ShmRing{Int}(mem; offset=64) # as attached by another process
+        @test_throws ArgumentError ShmRing{Int32}(mem; offset=64)
+        @test IPC.trypop!(other) === 1
+        @test pop!(other) === 2
+        @test isempty(ring)
+        # Batched operations wrapping around the end of the ring.
+        @test IPC.trypush!(ring, collect(3:7)) == 5
+        buf = zeros(Int, 4)
+        @test IPC.trypop!(other, buf) == 4
+        @test buf == 3:6
+        @test IPC.trypush!(ring, collect(8:20)) == 7
+        @test IPC.isfull(ring)
+        @test IPC.trypush!(ring, 21) == false
+        @test IPC.trypush!(ring, [21]) == 0
+        buf = zeros(Int, 10)
+        @test IPC.trypop!(other, buf) == 8
+        @test buf[1:8] == 7:14
+        @test IPC.trypop!(other, buf) == 0
+        # Blocking operations by concurrent tasks.
+        ring = ShmRing{Float64}(mem, 16; offset=1 << 13)
+        other = ShmRing{Float64}(mem; offset=1 << 13)
+        n = 10_000
+        producer = Threads.@spawn begin
+            for i in 1:2:n
+                push!(ring, i)
+            end
+            append!(ring, collect(2.0:2:n))
+        end
+        vals = Float64[pop!(other) for i in 1:div(n, 2)]
+        append!(vals, read!(other, zeros(Float64, div(n, 2))))
+        wait(producer)
+        @test vals == vcat(1:2:n, 2:2:n)
+        @test isempty(other)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Shared Memory Queue   " begin
+    begin
+        mem = SharedMemory(IPC.PRIVATE, 1 << 16)
+        @test_throws ArgumentError ShmQueue{Int}(mem, 12)
+        @test_throws ArgumentError ShmQueue{Int}(mem; offset=1024)
+        queue = ShmQueue{Int16}(mem, 4)
+        @test IPC.capacity(queue) == 4
+        @test isempty(queue) && !IPC.isfull(queue)
+        @test IPC.trypop!(queue) === nothing
+        other = ShmQueue{Int16}(mem) # as attached by another process
+        @test_throws ArgumentError ShmQueue{Int}(mem)
+        for turn in 1:3
+            @test all(i -> IPC.trypush!(queue, 10turn + i), 1:4)
+            @test IPC.isfull(other)
+            @test IPC.trypush!(queue, 0) == false
+            @test length(other) == 4
+            @test [pop!(other) for i in 1:4] == 10turn .+ (1:4)
+            @test IPC.trypop!(other) === nothing
+        end
+        # Concurrent producers and consumers.
+        queue = ShmQueue{Int}(mem, 64; offset=1 << 15)
+        n, m = 4, 2000
+        producers = [Threads.@spawn(for i in 1:m
+                                        push!(queue, (k - 1)*m + i)
+                                    end) for k in 1:n]
+        consumers = [Threads.@spawn([pop!(queue) for i in 1:m]) for k in 1:n]
+        foreach(wait, producers)
+        vals = reduce(vcat, fetch.(consumers))
+        @test sort(vals) == 1:n*m
+        @test isempty(queue)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Broadcast Ring        " begin
+    begin
+        @test sizeof(ShmBroadcast, 100, 4) == 128 + 4*(64 + 128)
+        mem = SharedMemory(IPC.PRIVATE, 1 << 14)
+        @test_throws ArgumentError ShmBroadcast(mem, 100, 3)
+        @test_throws ArgumentError ShmBroadcast(mem; offset=4096)
+        writer = ShmBroadcast(mem, 100, 4)
+        @test IPC.capacity(writer) == 4
+        @test IPC.slotsize(writer) == 100
+        @test_throws ErrorException IPC.publish!(writer)
+        reader1 = ShmBroadcast(mem) # as attached by another process
+        @test IPC.tryfetch(reader1) === nothing
+        A = IPC.claim!(writer)
+        @test isa(A, WrappedArray{UInt8,1})
+        @test length(A) == 100
+        A[1:16] .= reinterpret(UInt8, [1.0, 2.0])
+        IPC.publish!(writer, 16)
+        reader2 = ShmBroadcast(mem) # only reads new frames
+        B = IPC.tryfetch(reader1, Float64)
+        @test B == [1.0, 2.0]
+        @test IPC.validate!(reader1)
+        @test IPC.tryfetch(reader1) === nothing
+        @test IPC.tryfetch(reader2) === nothing
+        for k in 1:6
+            A = IPC.claim!(writer)
+            A[1] = k
+            IPC.publish!(writer)
+        end
+        # Reader has been lapped.
+        B = IPC.tryfetch(reader1)
+        @test length(B) == 100
+        @test B[1] == 6
+        @test IPC.dropped(reader1) == 5
+        # Frame overwritten while being read.
+        for k in 7:9
+            A = IPC.claim!(writer)
+            A[1] = k
+            IPC.publish!(writer)
+        end
+        A = IPC.claim!(writer) # overwrite the slot of frame 6
+        @test IPC.validate!(reader1) == false
+        @test IPC.dropped(reader1) == 6
+        A[1] = 10
+        IPC.publish!(writer)
+        @test fetch(reader1)[1] == 7
+        @test IPC.validate!(reader1)
+        @test IPC.dropped(reader2) == 0
+        @test fetch(reader2)[1] == 10
+        @test IPC.validate!(reader2)
+        @test IPC.dropped(reader2) == 9
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+# Structure protected by a sequence lock.
+struct SeqLockState
+    a::Int
+    b::Float64
+    c::NTuple{3,Int16}
+end
+
+@testset "Sequence Locks        " begin
+    begin
+        mem = SharedMemory(IPC.PRIVATE, 1 << 14)
+        @test sizeof(ShmSeqLock{SeqLockState}, ()) == 128 + sizeof(SeqLockState)
+        @test_throws ArgumentError ShmSeqLock{Int}(mem, (1,1,1,1,1))
+        @test_throws ArgumentError ShmSeqLock{Int}(mem; offset=4096)
+        lock = ShmSeqLock{SeqLockState}(mem, ())
+        @test size(lock) == ()
+        @test lock[] == SeqLockState(0, 0.0, (0, 0, 0))
+        lock[] = SeqLockState(1, 2.0, (3, 4, 5))
+        other = ShmSeqLock{SeqLockState}(mem) # as attached by another process
+        @test isa(other, ShmSeqLock{SeqLockState,0})
+        @test other[] == SeqLockState(1, 2.0, (3, 4, 5))
+        @test_throws ArgumentError ShmSeqLock{Int}(mem)
+        # Protected array.
+        lock = ShmSeqLock{Float32}(mem, (3, 4); offset=4096)
+        other = ShmSeqLock{Float32}(mem; offset=4096)
+        @test size(other) == (3, 4)
+        @test other[] == zeros(Float32, 3, 4)
+        copyto!(lock, Float32.(reshape(1:12, 3, 4)))
+        @test other[] == reshape(1:12, 3, 4)
+        @test IPC.update!(A -> (A[2, 3] = -1; sum(A)), lock) == 78 - 9
+        buf = zeros(Float32, 12)
+        @test read!(other, buf)[8] == -1
+        @test_throws DimensionMismatch read!(other, zeros(Float32, 5))
+        # Readers never see torn data.
+        lock = ShmSeqLock{Int}(mem, (64,); offset=8192)
+        ok = Threads.Atomic{Bool}(true)
+        done = Threads.Atomic{Bool}(false)
+        reader = Threads.@spawn begin
+            buf = zeros(Int, 64)
+            while !done[]
+                read!(lock, buf)
+                all(isequal(buf[1]), buf) || (ok[] = false)
+                yield()
+            end
+        end
+        for k in 1:2000
+            IPC.update!(A -> fill!(A, k), lock)
+            k % 100 == 0 && yield()
+        end
+        done[] = true
+        wait(reader)
+        @test ok[]
+        @test lock[] == fill(2000, 64)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Triple Buffers        " begin
+    begin
+        @test sizeof(ShmTripleBuffer{Float64}, (3, 5)) == 256 + 3*128
+        mem = SharedMemory(IPC.PRIVATE, 1 << 14)
+        @test_throws ArgumentError ShmTripleBuffer{Int}(mem; offset=4096)
+        producer = ShmTripleBuffer{Float64}(mem, (3, 5))
+        consumer = ShmTripleBuffer{Float64}(mem) # as attached by another process
+        @test size(consumer) == (3, 5)
+        @test_throws ArgumentError ShmTripleBuffer{Int32}(mem)
+        @test IPC.tryfetch(consumer) === nothing
+        A = IPC.claim!(producer)
+        @test isa(A, WrappedArray{Float64,2})
+        fill!(A, 1)
+        IPC.publish!(producer)
+        B = IPC.claim!(producer)
+        @test pointer(B) != pointer(A)
+        fill!(B, 2)
+        IPC.publish!(producer) # overwrites the unread version
+        C = IPC.tryfetch(consumer)
+        @test pointer(C) == pointer(B)
+        @test all(isequal(2), C)
+        @test IPC.tryfetch(consumer) === nothing
+        @test fetch(consumer) === C
+        # The producer never writes in the buffer of the consumer.
+        for k in 3:10
+            D = IPC.claim!(producer)
+            @test pointer(D) != pointer(C)
+            fill!(D, k)
+            IPC.publish!(producer)
+        end
+        @test all(isequal(2), C)
+        @test all(isequal(10), fetch(consumer))
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Atomic Operations     " begin
+    begin
+        mem = SharedMemory(IPC.PRIVATE, 4096)
+        A = WrappedArray(mem, Int64, 16)
+        fill!(A, 0)
+        @test IPC.atomic_load(A, 3) == 0
+        @test IPC.atomic_store!(A, 3, 7, :release) === nothing
+        @test IPC.atomic_load(A, 3, :acquire) == 7
+        @test IPC.atomic_add!(A, 3, 5) == 7
+        @test IPC.atomic_xchg!(A, 3, -1, :acquire_release) == 12
+        @test IPC.atomic_cas!(A, 3, 0, 1) == (-1, false)
+        @test IPC.atomic_cas!(A, 3, -1, 1, :acquire_release) == (-1, true)
+        @test A[3] == 1
+        @test_throws BoundsError IPC.atomic_load(A, 17)
+        Threads.@threads for i in 1:1000
+            IPC.atomic_add!(A, 1 + i % 4, 1)
+        end
+        @test A[1:4] == [250, 250, 250, 250]
+        # Raw offsets in the memory object.
+        @test IPC.atomic_load(mem, Int64, 16) == 1
+        @test IPC.atomic_add!(mem, UInt8, 1000, 3) == 0
+        @test IPC.atomic_load(mem, UInt8, 1000) == 3
+        @test IPC.atomic_store!(mem, Float64, 1024, 1.5) === nothing
+        @test IPC.atomic_add!(mem, Float64, 1024, 0.25) == 1.5
+        @test IPC.atomic_xchg!(mem, Float32, 2048, 2) == 0
+        @test IPC.atomic_cas!(mem, Int16, 3000, 0, 9) == (0, true)
+        B = WrappedArray(mem, Float64, 1; offset=1024)
+        @test IPC.atomic_load(B, 1) == 1.75
+        @test_throws ArgumentError IPC.atomic_load(mem, Int64, 4092)
+        @test_throws ArgumentError IPC.atomic_load(mem, Int64, 4)
+        @test_throws ArgumentError IPC.atomic_load(mem, ComplexF64, 0)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Futexes               " begin
+    if Sys.islinux()
+        mem = SharedMemory(IPC.PRIVATE, 4096)
+        IPC.atomic_store!(mem, UInt32, 64, 3)
+        @test IPC.futex_wait(mem, 64, 2) # value differs, returns at once
+        t = time()
+        @test !IPC.futex_wait(mem, 64, 3; timeout=0.05)
+        @test time() - t ≥ 0.04
+        @test IPC.futex_wake(mem, 64) == 0
+        @test IPC.futex_wake(mem, 64, typemax(Int)) == 0
+        @test_throws ArgumentError IPC.futex_wait(mem, 66, 3)
+        @test_throws ArgumentError IPC.futex_wake(mem, 4096)
+        if Threads.nthreads() ≥ 2
+            task = Threads.@spawn begin
+                while IPC.atomic_load(mem, UInt32, 64, :acquire) == 3
+                    IPC.futex_wait(mem, 64, 3; timeout=10)
+                end
+                IPC.atomic_load(mem, UInt32, 64)
+            end
+            sleep(0.1)
+            IPC.atomic_store!(mem, UInt32, 64, 4, :release)
+            IPC.futex_wake(mem, 64)
+            @test fetch(task) == 4
+        end
+    else
+        mem = SharedMemory(IPC.PRIVATE, 4096)
+        @test_throws SystemError IPC.futex_wake(mem, 64)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Adaptive Mutexes      " begin
+    begin
+        mem = SharedMemory(IPC.PRIVATE, 4096)
+        m1 = IPC.AdaptiveMutex(mem, 64; spins=200)
+        m2 = IPC.AdaptiveMutex(mem, 64; init=false) # as in another process
+        @test_throws ArgumentError IPC.AdaptiveMutex(mem, 66)
+        @test !islocked(m1)
+        lock(m1)
+        @test islocked(m1)
+        @test_throws ErrorException lock(m1)
+        @test !trylock(m2)
+        unlock(m1)
+        @test_throws ErrorException unlock(m1)
+        @test trylock(m2)
+        unlock(m2)
+        @test IPC.lockstats(m1) == (fast = 1, spun = 0, parked = 0)
+        @test IPC.lockstats(m2) == (fast = 1, spun = 0, parked = 0)
+        if Threads.nthreads() ≥ 2
+            # Without spinning, a contended mutex sleeps in the kernel (or
+            # polls the mutex where futexes are not available).
+            lock(m1)
+            task = Threads.@spawn begin
+                m = IPC.AdaptiveMutex(mem, 64; spins=0, init=false)
+                lock(m)
+                unlock(m)
+                IPC.lockstats(m)
+            end
+            sleep(0.5)
+            unlock(m1)
+            @test fetch(task) == (fast = 0, spun = 0, parked = 1)
+            counter = WrappedArray(mem, Int, 1; offset=128)
+            counter[1] = 0
+            n = 10_000
+            tasks = map(1:Threads.nthreads()) do k
+                Threads.@spawn begin
+                    m = IPC.AdaptiveMutex(mem, 64; spins=100, init=false)
+                    for i in 1:n
+                        lock(m)
+                        counter[1] += 1
+                        unlock(m)
+                    end
+                    sum(IPC.lockstats(m))
+                end
+            end
+            @test sum(fetch, tasks) == n*Threads.nthreads()
+            @test counter[1] == n*Threads.nthreads()
+        end
+        m3 = IPC.AdaptiveMutex()
+        @test trylock(m3) && islocked(m3)
+        unlock(m3)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "GC-Safe Waits         " begin
+    if Threads.nthreads() ≥ 2
+        # A thread blocked on a semaphore must not prevent the garbage
+        # collector from running in other threads.  Without GC-safe waits,
+        # the garbage collection would only complete when the wait times
+        # out.  Before Julia 1.9, only check that the waits work.
+        buf = DynamicMemory(sizeof(Semaphore))
+        sem = Semaphore(buf, 0)
+        task = Threads.@spawn try
+            timedwait(sem, 20)
+            true
+        catch ex
+            ex isa TimeoutError || rethrow()
+            false
+        end
+        sleep(0.5)
+        elapsed = @elapsed GC.gc()
+        post(sem)
+        @test fetch(task)
+        @test elapsed < 10 || !IPC._GC_SAFE_CALLS
+        # Idem for a thread sleeping.
+        task = Threads.@spawn nanosleep(5)
+        sleep(0.5)
+        elapsed = @elapsed GC.gc()
+        wait(task)
+        @test elapsed < 4 || !IPC._GC_SAFE_CALLS
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Semaphore Sets        " begin
+    begin
+        set = SemaphoreSet(IPC.PRIVATE, 3; value=1)
+        @test length(set) == 3
+        @test set[:] == [1, 1, 1]
+        set[2] = 2
+        @test set[2] == 2
+        @test_throws ArgumentError set[4]
+        @test_throws ArgumentError set[1] = -1
+        @test IPC.semop(set, 1 => -1, 2 => -2)
+        @test set[:] == [0, 0, 1]
+        # Operations are atomic: none is done if one would block.
+        @test !IPC.semop(set, 3 => -1, 1 => -1; nowait=true)
+        @test set[:] == [0, 0, 1]
+        @test IPC.semop(set, 1 => 0, 3 => -1; undo=true)
+        @test set[3] == 0
+        @test IPC.semop(set, 1 => 1, 2 => 2, 3 => 1)
+        info = IPC.SemInfo(set)
+        @test info.nsems == 3 && info.id == set.id
+        if Sys.islinux()
+            t = time()
+            @test !IPC.semop(set, 1 => -2; timeout=0.1)
+            @test time() - t ≥ 0.05
+        end
+        rm(set)
+        @test_throws ErrorException set[1]
+        @test_throws ArgumentError SemaphoreSet(IPC.PRIVATE, 0)
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Event Semaphores      " begin
+    if Sys.islinux()
+        sem = EventSemaphore(2)
+        @test isopen(sem) && fd(sem) ≥ 0
+        @test trywait(sem)
+        wait(sem)
+        @test !trywait(sem)
+        @test_throws TimeoutError timedwait(sem, 0.1)
+        post(sem)
+        post(sem)
+        @test trywait(sem) && trywait(sem) && !trywait(sem)
+        # Waiting does not block other tasks.
+        task = @async wait(sem)
+        sleep(0.1)
+        @test !istaskdone(task)
+        post(sem)
+        wait(task)
+        @test !trywait(sem)
+        task = @async timedwait(sem, 10)
+        yield()
+        post(sem)
+        @test fetch(task) === nothing
+        # Share the semaphore through a Unix socket.
+        sock1, sock2 = IPC.socketpair()
+        IPC.sendfd(sock1, sem)
+        other = EventSemaphore(IPC.recvfd(sock2))
+        post(other)
+        @test trywait(sem)
+        close(sem)
+        @test !isopen(sem)
+        @test_throws ArgumentError EventSemaphore(-1)
+    else
+        @test_throws SystemError EventSemaphore()
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
+@testset "Wait on Any Object    " begin
+    if Sys.islinux()
+        sems = [EventSemaphore() for i in 1:3]
+        @test IPC.waitany(sems; timeout=0.1) == 0
+        post(sems[3])
+        post(sems[2])
+        @test IPC.waitany(sems) == 2
+        @test IPC.waitany(sems) == 3
+        @test IPC.waitany(sems; timeout=0) == 0
+        # Waiting does not block other tasks.
+        task = @async IPC.waitany(sems; timeout=10)
+        sleep(0.1)
+        @test !istaskdone(task)
+        post(sems[1])
+        @test fetch(task) == 1
+        @test_throws ArgumentError IPC.waitany(EventSemaphore[])
+        # Futex words, the `futex_waitv` system call may not be supported.
+        mem = SharedMemory(IPC.PRIVATE, 4096)
+        IPC.atomic_store!(mem, UInt32, 0, 0)
+        IPC.atomic_store!(mem, UInt32, 4, 5)
+        words = [(mem, 0, 0), (mem, 4, 5)]
+        try
+            @test IPC.waitany(words; timeout=0.05) == 0
+            IPC.atomic_store!(mem, UInt32, 4, 6)
+            @test IPC.waitany(words) == 2
+        catch err
+            @test err isa SystemError && err.errnum == Libc.ENOSYS
+        end
+        @test_throws ArgumentError IPC.waitany(Tuple{Any,Int,Int}[])
+    end
+    GC.gc() # call garbage collector to exercise the finalizers
+end
+
 @testset "Wrapped Shared Arrays " begin
     begin
         T = Float32